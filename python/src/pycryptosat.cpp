@@ -24,6 +24,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 **********************************/
 
+#define PY_SSIZE_T_CLEAN
 #include <Python.h>
 #include <structmember.h>
 #include <limits>
@@ -45,6 +46,7 @@ typedef struct {
     /* Type-specific fields go here. */
     SATSolver* cmsat;
     std::vector<Lit> tmp_cl_lits;
+    Py_ssize_t model_exports; //number of live buffers over the model
 
     int verbose;
     double time_limit;
@@ -263,34 +265,49 @@ static int _add_clauses_from_array(Solver *self, const size_t array_length, cons
         PyErr_SetString(PyExc_ValueError, "last clause not terminated by zero");
         return 0;
     }
-    size_t k = 0;
-    long val = 0;
+
+    // Only plain C++ below, so we can let other Python threads run while
+    // the (possibly huge) buffer is converted and handed to the solver
+    long bad_val = 0;
+    bool bad = false;
+    Py_BEGIN_ALLOW_THREADS      /* release GIL */
     std::vector<Lit>& lits = self->tmp_cl_lits;
-    for (val = (long) array[k]; k < array_length; val = (long) array[++k]) {
-        lits.clear();
-        long int max_var = 0;
-        for (; k < array_length && val != 0; val = (long) array[++k]) {
-            long var;
-            bool sign;
-            if (val > std::numeric_limits<int>::max()/2
-                || val < std::numeric_limits<int>::min()/2
-            ) {
-                PyErr_Format(PyExc_ValueError, "integer %ld is too small or too large", val);
-                return 0;
+    lits.clear();
+    lits.reserve(array_length);
+    long max_var = -1;
+    for (size_t k = 0; k < array_length; k++) {
+        const long val = (long) array[k];
+        if (val == 0) {
+            // Empty clauses (i.e. "0 0") were always skipped
+            if (!lits.empty() && lits.back() != lit_Undef) {
+                lits.push_back(lit_Undef);
             }
-
-            sign = (val < 0);
-            var = std::abs(val) - 1;
-            max_var = std::max(var, max_var);
-
-            lits.push_back(Lit(var, sign));
+            continue;
         }
-        if (!lits.empty()) {
-            if (max_var >= (long int)self->cmsat->nVars()) {
-                self->cmsat->new_vars(max_var-(long int)self->cmsat->nVars()+1);
-            }
-            self->cmsat->add_clause(lits);
+        if (val > std::numeric_limits<int>::max()/2
+            || val < std::numeric_limits<int>::min()/2
+        ) {
+            bad_val = val;
+            bad = true;
+            break;
+        }
+        const long var = std::abs(val) - 1;
+        max_var = std::max(var, max_var);
+        lits.push_back(Lit(var, val < 0));
+    }
+
+    if (!bad && !lits.empty()) {
+        if (max_var >= (long)self->cmsat->nVars()) {
+            self->cmsat->new_vars(max_var-(long)self->cmsat->nVars()+1);
         }
+        self->cmsat->add_clauses(lits);
+    }
+    lits.clear();
+    Py_END_ALLOW_THREADS
+
+    if (bad) {
+        PyErr_Format(PyExc_ValueError, "integer %ld is too small or too large", bad_val);
+        return 0;
     }
     return 1;
 }
@@ -422,10 +439,11 @@ static PyObject* get_solution(SATSolver *cmsat)
     Py_INCREF(Py_None);
     PyTuple_SET_ITEM(tuple, (Py_ssize_t)0, Py_None);
 
+    const std::vector<lbool>& model = cmsat->get_model();
     PyObject *py_value = NULL;
     lbool v;
     for (unsigned i = 0; i < max_idx; i++) {
-        v = cmsat->get_model()[i];
+        v = model[i];
 
         if (v == l_True) {
             py_value = Py_True;
@@ -483,6 +501,18 @@ static PyObject* nb_vars(Solver *self)
 
 }
 
+// The model buffer points straight into the solver, so it must not be
+// overwritten by a new solve() while someone is still looking at it
+static int check_no_model_exports(Solver *self)
+{
+    if (self->model_exports > 0) {
+        PyErr_SetString(PyExc_BufferError,
+            "cannot solve while a view of the model is still alive, release it first");
+        return 0;
+    }
+    return 1;
+}
+
 static int parse_assumption_lits(PyObject* assumptions, SATSolver* cmsat, std::vector<Lit>& assumption_lits)
 {
     PyObject *iterator = PyObject_GetIter(assumptions);
@@ -519,7 +549,7 @@ static int parse_assumption_lits(PyObject* assumptions, SATSolver* cmsat, std::v
 }
 
 PyDoc_STRVAR(solve_doc,
-"solve(assumptions=None, verbose=None, time_limit=None, confl_limit=None)\n\
+"solve(assumptions=None, verbose=None, time_limit=None, confl_limit=None, return_model=True)\n\
 Solve the system of equations that have been added with add_clause();\n\
 \n\
 .. example:: \n\
@@ -558,6 +588,10 @@ Solve the system of equations that have been added with add_clause();\n\
 :param confl_limit: (Optional) Allows the user to set a conflict limit for just\n\
     this solve.\n\
 :type confl_limit: <long>\n\
+:param return_model: (Optional) If False, the solution is not converted into\n\
+    a tuple and None is returned in its place. Use get_model_view() to\n\
+    access the model without copying it.\n\
+:type return_model: <bool>\n\
 :return: A tuple. First part of the tuple indicates whether the problem\n\
     is satisfiable. The second part is a tuple contains the solution,\n\
     preceded by None, so you can index into it with the variable number.\n\
@@ -573,9 +607,13 @@ static PyObject* solve(Solver *self, PyObject *args, PyObject *kwds)
     int verbose = self->verbose;
     double time_limit = self->time_limit;
     long confl_limit = self->confl_limit;
+    int return_model = 1;
 
-    static char const* kwlist[] = {"assumptions", "verbose", "time_limit", "confl_limit", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oidl", const_cast<char**>(kwlist), &assumptions, &verbose, &time_limit, &confl_limit)) {
+    static char const* kwlist[] = {"assumptions", "verbose", "time_limit", "confl_limit", "return_model", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oidlp", const_cast<char**>(kwlist), &assumptions, &verbose, &time_limit, &confl_limit, &return_model)) {
+        return NULL;
+    }
+    if (!check_no_model_exports(self)) {
         return NULL;
     }
     if (verbose < 0) {
@@ -617,7 +655,13 @@ static PyObject* solve(Solver *self, PyObject *args, PyObject *kwds)
     self->cmsat->set_max_time(self->time_limit);
     self->cmsat->set_max_confl(self->confl_limit);
 
-    if (res == l_True) {
+    if (res == l_True && !return_model) {
+        Py_INCREF(Py_True);
+        Py_INCREF(Py_None);
+
+        PyTuple_SET_ITEM(result, 0, Py_True);
+        PyTuple_SET_ITEM(result, 1, Py_None);
+    } else if (res == l_True) {
         PyObject* solution = get_solution(self->cmsat);
         if (!solution) {
             Py_DECREF(result);
@@ -661,6 +705,10 @@ Return satisfiability of the system.\n\
 
 static PyObject* is_satisfiable(Solver *self)
 {
+    if (!check_no_model_exports(self)) {
+        return NULL;
+    }
+
     lbool res;
     Py_BEGIN_ALLOW_THREADS      /* release GIL */
     res = self->cmsat->solve();
@@ -710,6 +758,91 @@ static PyObject* get_conflict(Solver *self)
     return result;
 }
 
+PyDoc_STRVAR(get_conflict_array_doc,
+"get_conflict_array()\n\
+Same as get_conflict(), but returns the literals as a compact array of\n\
+32-bit signed integers that supports the buffer protocol.\n\
+\n\
+:return: Which assumptions (as passed to solve(...)) are incorrect\n\
+:rtype: <array.array('i')>"
+);
+
+static PyObject* get_conflict_array(Solver *self)
+{
+    const std::vector<Lit>& conflict = self->cmsat->get_conflict();
+    std::vector<int32_t> lits(conflict.size());
+    for (size_t i = 0; i < conflict.size(); i++) {
+        const Lit lit = conflict[i];
+        lits[i] = lit.sign() ? -(int32_t)(lit.var()+1) : (int32_t)(lit.var()+1);
+    }
+
+    PyObject* array_mod = PyImport_ImportModule("array");
+    if (array_mod == NULL) {
+        return NULL;
+    }
+    PyObject* result = PyObject_CallMethod(array_mod, "array", "sy#", "i",
+        (const char*)lits.data(), (Py_ssize_t)(lits.size()*sizeof(int32_t)));
+    Py_DECREF(array_mod);
+    return result;
+}
+
+PyDoc_STRVAR(get_model_view_doc,
+"get_model_view()\n\
+Returns a read-only view of the model found by the last call to solve()\n\
+without copying it. Index i holds the value of variable i+1 as one byte:\n\
+0 is True, 1 is False and 2 or 3 is unassigned. Only meaningful if the last\n\
+call to solve() returned True.\n\
+\n\
+.. example:: \n\
+    >>> s.solve(return_model=False)\n\
+    >>> model = numpy.frombuffer(s.get_model_view(), dtype=numpy.uint8)\n\
+\n\
+Calling solve() while such a view (or a numpy array created from it) is\n\
+still alive raises BufferError.\n\
+\n\
+:return: The model\n\
+:rtype: <memoryview>"
+);
+
+static PyObject* get_model_view(Solver *self)
+{
+    return PyMemoryView_FromObject((PyObject*)self);
+}
+
+static int Solver_getbuffer(Solver *self, Py_buffer *view, int flags)
+{
+    static uint8_t empty = 0;
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "the model is read-only");
+        view->obj = NULL;
+        return -1;
+    }
+
+    // lbool is a single byte, so the model can be exposed as-is
+    static_assert(sizeof(lbool) == sizeof(uint8_t), "lbool must be one byte");
+    const std::vector<lbool>& model = self->cmsat->get_model();
+    const size_t num = std::min<size_t>(model.size(), self->cmsat->nVars());
+    void* buf = num == 0 ? (void*)&empty : (void*)model.data();
+    if (PyBuffer_FillInfo(view, (PyObject*)self, buf, (Py_ssize_t)num, 1, flags) != 0) {
+        return -1;
+    }
+    if (flags & PyBUF_FORMAT) {
+        view->format = const_cast<char*>("B");
+    }
+    self->model_exports++;
+    return 0;
+}
+
+static void Solver_releasebuffer(Solver *self, Py_buffer *)
+{
+    self->model_exports--;
+}
+
+static PyBufferProcs Solver_as_buffer = {
+    (getbufferproc)Solver_getbuffer,
+    (releasebufferproc)Solver_releasebuffer,
+};
+
 /*************************** Method definitions *************************/
 
 static PyMethodDef Solver_methods[] = {
@@ -721,6 +854,8 @@ static PyMethodDef Solver_methods[] = {
     //{"nb_clauses", (PyCFunction) nb_clauses, METH_VARARGS | METH_KEYWORDS, "returns number of clauses"},
     {"is_satisfiable", (PyCFunction) is_satisfiable, METH_VARARGS | METH_KEYWORDS, is_satisfiable_doc},
     {"get_conflict", (PyCFunction) get_conflict, METH_VARARGS | METH_KEYWORDS, get_conflict_doc},
+    {"get_conflict_array", (PyCFunction) get_conflict_array, METH_NOARGS, get_conflict_array_doc},
+    {"get_model_view", (PyCFunction) get_model_view, METH_NOARGS, get_model_view_doc},
     {NULL,        NULL}  /* sentinel - marks the end of this structure */
 };
 
@@ -734,6 +869,9 @@ Solver_dealloc(Solver* self)
 static int
 Solver_init(Solver *self, PyObject *args, PyObject *kwds)
 {
+    if (!check_no_model_exports(self)) {
+        return -1;
+    }
     if (self->cmsat != NULL) {
         delete self->cmsat;
     }
@@ -764,7 +902,7 @@ static PyTypeObject pycryptosat_SolverType = {
     0,                          /*tp_str*/
     0,                          /*tp_getattro*/
     0,                          /*tp_setattro*/
-    0,                          /*tp_as_buffer*/
+    &Solver_as_buffer,          /*tp_as_buffer*/
     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /*tp_flags*/
     solver_create_docstring,    /* tp_doc */
     0,                          /* tp_traverse */
@@ -264,6 +264,38 @@ class TestSolve(unittest.TestCase):
         self.assertNotIn(2, confl)
         self.assertIn(-4, confl)
 
+    def test_get_conflict_array(self):
+        self.solver.add_clauses([[-1], [2], [3], [-4]])
+        res, model = self.solver.solve(assumptions=[2, 4])
+        self.assertEqual(res, False)
+
+        confl = self.solver.get_conflict_array()
+        self.assertEqual(confl.typecode, 'i')
+        self.assertEqual(list(confl), self.solver.get_conflict())
+
+    def test_model_view(self):
+        for cl in clauses1:
+            self.solver.add_clause(cl)
+        res, solution = self.solver.solve(return_model=False)
+        self.assertEqual(res, True)
+        self.assertEqual(solution, None)
+
+        view = self.solver.get_model_view()
+        self.assertTrue(view.readonly)
+        self.assertEqual(view.format, 'B')
+        self.assertEqual(len(view), self.solver.nb_vars())
+        solution = (None,) + tuple(v == 0 for v in view)
+        self.assertTrue(check_solution(clauses1, solution))
+
+        self.assertRaises(BufferError, self.solver.solve)
+        view.release()
+        res, _ = self.solver.solve()
+        self.assertEqual(res, True)
+
+    def test_add_clauses_array_too_large(self):
+        cls = array('q', [1, 2, 0, 2**40, 0])
+        self.assertRaises(ValueError, self.solver.add_clauses, cls)
+
     def test_cnf2(self):
         for cl in clauses2:
             self.solver.add_clause(cl)
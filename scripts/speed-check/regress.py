@@ -0,0 +1,387 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+"""End-to-end performance regression harness.
+
+  regress.py run --binary ./cryptominisat5 --label my-change manifest.json
+  regress.py list
+  regress.py compare baseline my-change
+
+"run" solves every instance of the manifest under each of its seeds and
+thread counts. It records the result, wall time, conflicts/s,
+propagations/s and peak RSS, and appends the run to a JSON history file.
+SAT answers are checked with scripts/fuzz/verifier.py. Answers are also
+checked against the manifest's "expect" field.
+
+"compare" pairs up the runs of two labels on the same (instance, seed,
+threads). It reports the geometric mean speedup with a bootstrap
+confidence interval and a Wilcoxon signed-rank test. Timeouts are scored
+as twice the time limit (PAR-2). Differences below --min-time on both
+sides are ignored, they are noise.
+
+The manifest is JSON:
+
+  {"timeout": 300, "seeds": [1, 2, 3], "threads": [1],
+   "extra_args": ["--verb", "1"],
+   "instances": [
+     {"file": "bench/foo.cnf.gz", "sha256": "...", "expect": "UNSAT"},
+     {"generate": {"kind": "random-ksat", "vars": 400, "ratio": 4.26,
+                   "k": 3, "seed": 1}}
+   ]}
+
+Paths are relative to the manifest. A "sha256" pins a file, a run refuses
+to start if the file changed. Generated instances are deterministic.
+"""
+
+import argparse
+import hashlib
+import json
+import math
+import os
+import platform
+import random
+import re
+import subprocess
+import sys
+import threading
+import time
+from datetime import datetime, timezone
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "fuzz"))
+from verifier import solution_parser  # noqa: E402
+
+
+def sha256_of(fname):
+    h = hashlib.sha256()
+    with open(fname, "rb") as f:
+        for block in iter(lambda: f.read(1 << 20), b""):
+            h.update(block)
+    return h.hexdigest()
+
+
+def generate_instance(spec, cache_dir):
+    assert spec["kind"] == "random-ksat", "Only 'random-ksat' can be generated"
+    k = spec.get("k", 3)
+    n = spec["vars"]
+    m = int(n * spec["ratio"])
+    name = "random-%dsat-v%d-r%s-s%d.cnf" % (k, n, spec["ratio"], spec["seed"])
+    fname = os.path.join(cache_dir, name)
+    if os.path.exists(fname):
+        return fname
+
+    rnd = random.Random(spec["seed"])
+    os.makedirs(cache_dir, exist_ok=True)
+    with open(fname + ".tmp", "w") as f:
+        f.write("p cnf %d %d\n" % (n, m))
+        for _ in range(m):
+            cl_vars = rnd.sample(range(1, n + 1), k)
+            f.write(" ".join(str(v if rnd.random() < 0.5 else -v) for v in cl_vars))
+            f.write(" 0\n")
+    os.rename(fname + ".tmp", fname)
+    return fname
+
+
+def load_manifest(fname, cache_dir):
+    with open(fname) as f:
+        manifest = json.load(f)
+    base = os.path.dirname(os.path.abspath(fname))
+
+    instances = []
+    for inst in manifest["instances"]:
+        if "generate" in inst:
+            path = generate_instance(inst["generate"], cache_dir)
+        else:
+            path = os.path.join(base, inst["file"])
+            if "sha256" in inst and sha256_of(path) != inst["sha256"]:
+                print("ERROR: '%s' does not match its pinned sha256 in the manifest" % path)
+                exit(-1)
+        instances.append({"path": path,
+                          "name": os.path.basename(path),
+                          "expect": inst.get("expect")})
+    manifest["instances"] = instances
+    return manifest
+
+
+def parse_stats(lines):
+    stats = {"conflicts": None, "props": None}
+    for line in lines:
+        m = re.match(r"^c conflicts\s*:\s*([0-9]+)", line)
+        if m:
+            stats["conflicts"] = int(m.group(1))
+        m = re.match(r"^c Mprops\s*:\s*([0-9.]+)", line)
+        if m:
+            stats["props"] = float(m.group(1)) * 1e6
+    return stats
+
+
+def solve_one(binary, inst, seed, threads, timeout, extra_args):
+    cmd = [binary, "--random", str(seed), "--threads", str(threads)]
+    cmd += extra_args + [inst["path"]]
+
+    start = time.monotonic()
+    p = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                         universal_newlines=True)
+    timed_out = threading.Event()
+
+    def kill():
+        timed_out.set()
+        p.kill()
+    timer = threading.Timer(timeout, kill)
+    timer.start()
+    out = p.stdout.read()
+    p.stdout.close()
+    # wait4() instead of wait(), for the peak RSS of this child only
+    _, status, rusage = os.wait4(p.pid, 0)
+    timer.cancel()
+    p.returncode = status
+    wall = time.monotonic() - start
+    peak_rss_kb = rusage.ru_maxrss
+    lines = out.splitlines()
+
+    result = "TIMEOUT"
+    if not timed_out.is_set():
+        if any(l.startswith("s SATISFIABLE") for l in lines):
+            result = "SAT"
+        elif any(l.startswith("s UNSATISFIABLE") for l in lines):
+            result = "UNSAT"
+        elif any(l.startswith("s INDETERMINATE") for l in lines):
+            result = "UNKNOWN"
+        else:
+            result = "ERROR"
+
+    ok = True
+    if result == "SAT":
+        try:
+            _, solution, _ = solution_parser.parse_solution_from_output(lines)
+            solution_parser.test_found_solution(solution, inst["path"])
+        except Exception as e:
+            print("ERROR: wrong model for '%s' seed %d: %s" % (inst["path"], seed, e))
+            ok = False
+    if inst["expect"] is not None and result in ("SAT", "UNSAT") and result != inst["expect"]:
+        print("ERROR: '%s' seed %d gave %s, expected %s" % (inst["path"], seed, result, inst["expect"]))
+        ok = False
+
+    stats = parse_stats(lines)
+    rate = lambda x: None if x is None or wall <= 0 else x / wall
+    return {
+        "instance": inst["name"],
+        "seed": seed,
+        "threads": threads,
+        "result": result,
+        "correct": ok and result != "ERROR",
+        "wall_time": wall,
+        "conflicts": stats["conflicts"],
+        "conflicts_per_sec": rate(stats["conflicts"]),
+        "props": stats["props"],
+        "props_per_sec": rate(stats["props"]),
+        "peak_rss_mb": peak_rss_kb / 1024.0,
+    }
+
+
+def git_revision(binary):
+    try:
+        out = subprocess.run([binary, "--version"], stdout=subprocess.PIPE,
+                             universal_newlines=True, timeout=30).stdout
+    except (OSError, subprocess.TimeoutExpired):
+        return None
+    m = re.search(r"SHA revision:?\s*([0-9a-f]{7,})", out)
+    return m.group(1) if m else None
+
+
+def load_history(fname):
+    if not os.path.exists(fname):
+        return []
+    with open(fname) as f:
+        return json.load(f)
+
+
+def save_history(fname, history):
+    with open(fname + ".tmp", "w") as f:
+        json.dump(history, f, indent=1)
+    os.replace(fname + ".tmp", fname)
+
+
+def cmd_run(args):
+    manifest = load_manifest(args.manifest, args.cache_dir)
+    seeds = manifest.get("seeds", [1])
+    threads = manifest.get("threads", [1])
+    timeout = manifest.get("timeout", 300)
+    extra_args = manifest.get("extra_args", [])
+
+    runs = []
+    for inst in manifest["instances"]:
+        for t in threads:
+            for s in seeds:
+                r = solve_one(args.binary, inst, s, t, timeout, extra_args)
+                print("%-40s seed %-4d threads %-2d %-8s %8.2f s %6.0f MB" % (
+                      r["instance"], s, t, r["result"], r["wall_time"], r["peak_rss_mb"]))
+                runs.append(r)
+
+    history = load_history(args.history)
+    history.append({
+        "label": args.label,
+        "date": datetime.now(timezone.utc).isoformat(),
+        "binary": os.path.abspath(args.binary),
+        "revision": git_revision(args.binary),
+        "host": platform.node(),
+        "cpu": platform.processor(),
+        "manifest": os.path.abspath(args.manifest),
+        "timeout": timeout,
+        "runs": runs,
+    })
+    save_history(args.history, history)
+
+    wrong = [r for r in runs if not r["correct"]]
+    if wrong:
+        print("ERROR: %d wrong or failed answers" % len(wrong))
+        exit(-1)
+
+
+def cmd_list(args):
+    for h in load_history(args.history):
+        print("%-24s %s  rev %s  %d runs" % (h["label"], h["date"], h["revision"], len(h["runs"])))
+
+
+def latest_with_label(history, label):
+    for h in reversed(history):
+        if h["label"] == label:
+            return h
+    print("ERROR: no run labelled '%s' in the history" % label)
+    exit(-1)
+
+
+def par2(r, timeout):
+    if r["result"] in ("SAT", "UNSAT") and r["correct"]:
+        return r["wall_time"]
+    return 2.0 * timeout
+
+
+def wilcoxon_signed_rank(diffs):
+    """Two-sided p-value, normal approximation with tie correction"""
+    diffs = [d for d in diffs if d != 0]
+    n = len(diffs)
+    if n == 0:
+        return 1.0
+    order = sorted(range(n), key=lambda i: abs(diffs[i]))
+    ranks = [0.0] * n
+    tie_term = 0.0
+    i = 0
+    while i < n:
+        j = i
+        while j + 1 < n and abs(diffs[order[j + 1]]) == abs(diffs[order[i]]):
+            j += 1
+        for x in range(i, j + 1):
+            ranks[order[x]] = (i + j) / 2.0 + 1
+        t = j - i + 1
+        tie_term += t * t * t - t
+        i = j + 1
+    w_plus = sum(r for r, d in zip(ranks, diffs) if d > 0)
+    mean = n * (n + 1) / 4.0
+    var = n * (n + 1) * (2 * n + 1) / 24.0 - tie_term / 48.0
+    if var <= 0:
+        return 1.0
+    z = (abs(w_plus - mean) - 0.5) / math.sqrt(var)
+    return math.erfc(max(z, 0) / math.sqrt(2))
+
+
+def bootstrap_ci(log_ratios, iters=2000):
+    rnd = random.Random(0)
+    n = len(log_ratios)
+    means = sorted(sum(rnd.choice(log_ratios) for _ in range(n)) / n for _ in range(iters))
+    return math.exp(means[int(0.025 * iters)]), math.exp(means[int(0.975 * iters)])
+
+
+def cmd_compare(args):
+    history = load_history(args.history)
+    old = latest_with_label(history, args.old)
+    new = latest_with_label(history, args.new)
+    key = lambda r: (r["instance"], r["seed"], r["threads"])
+    old_runs = {key(r): r for r in old["runs"]}
+
+    log_ratios = []
+    solved_old = solved_new = 0
+    print("%-40s %5s %3s %10s %10s %8s" % ("instance", "seed", "thr", "old", "new", "speedup"))
+    for r in new["runs"]:
+        o = old_runs.get(key(r))
+        if o is None:
+            continue
+        t_old = par2(o, old["timeout"])
+        t_new = par2(r, new["timeout"])
+        solved_old += t_old < 2.0 * old["timeout"]
+        solved_new += t_new < 2.0 * new["timeout"]
+        print("%-40s %5d %3d %10.2f %10.2f %8.2f" % (
+              r["instance"], r["seed"], r["threads"], t_old, t_new, t_old / max(t_new, 1e-9)))
+        if t_old < args.min_time and t_new < args.min_time:
+            continue
+        log_ratios.append(math.log(t_old / max(t_new, 1e-9)))
+
+    print("Solved: %d -> %d" % (solved_old, solved_new))
+    if not log_ratios:
+        print("No instance ran long enough to compare, lower --min-time")
+        return
+    speedup = math.exp(sum(log_ratios) / len(log_ratios))
+    lo, hi = bootstrap_ci(log_ratios)
+    p = wilcoxon_signed_rank(log_ratios)
+    print("Geometric mean speedup of '%s' over '%s': %.3fx (95%% CI %.3f-%.3f), "
+          "Wilcoxon p = %.4f over %d pairs" % (args.new, args.old, speedup, lo, hi, p, len(log_ratios)))
+    if p < args.alpha:
+        print("Significant: %s" % ("faster" if speedup > 1 else "SLOWER"))
+        if speedup < 1 and args.fail_if_slower:
+            exit(1)
+    else:
+        print("Not significant at alpha = %g" % args.alpha)
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--history", default="regress-history.json",
+                        help="JSON file the runs are appended to")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    run = sub.add_parser("run", help="Run a manifest and record the results")
+    run.add_argument("manifest")
+    run.add_argument("--binary", default="./cryptominisat5")
+    run.add_argument("--label", required=True, help="Name of this build, e.g. 'baseline'")
+    run.add_argument("--cache-dir", default="regress-cache",
+                     help="Where generated instances are written")
+    run.set_defaults(func=cmd_run)
+
+    lst = sub.add_parser("list", help="List the recorded runs")
+    lst.set_defaults(func=cmd_list)
+
+    cmp = sub.add_parser("compare", help="Compare the latest runs of two labels")
+    cmp.add_argument("old")
+    cmp.add_argument("new")
+    cmp.add_argument("--alpha", type=float, default=0.05)
+    cmp.add_argument("--min-time", type=float, default=1.0,
+                     help="Ignore pairs where both took less than this many seconds")
+    cmp.add_argument("--fail-if-slower", action="store_true",
+                     help="Exit with 1 on a significant slowdown, for CI")
+    cmp.set_defaults(func=cmd_compare)
+    return parser.parse_args()
+
+
+if __name__ == "__main__":
+    args = parse_arguments()
+    args.func(args)
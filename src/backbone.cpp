@@ -31,6 +31,8 @@ using namespace CMSat;
 
 bool Solver::backbone_simpl(int64_t orig_max_confl, bool& finished)
 {
+    if (conf.backbone_native) return backbone_native(orig_max_confl, finished);
+
     vector<int> cnf;
     /* for(uint32_t i = 0; i < nVars(); i++) picosat_inc_max_var(picosat); */
 
@@ -71,6 +73,149 @@ bool Solver::backbone_simpl(int64_t orig_max_confl, bool& finished)
     return sat != 20;
 }
 
+//Runs the searcher under the assumptions currently in "assumptions", keeping
+//the learnt clauses, activities and phases for the next call
+lbool Solver::backbone_search(const uint64_t max_confl)
+{
+    fill_assumptions_set();
+    const lbool ret = Searcher::solve(max_confl);
+    unfill_assumptions_set();
+
+    sumSearchStats += Searcher::get_stats();
+    sumPropStats += propStats;
+    propStats.clear();
+    Searcher::resetStats();
+    return ret;
+}
+
+//A literal that is not the only true one in any irredundant clause can be
+//flipped in the model without falsifying anything, so it is not backbone
+void Solver::backbone_flip_filter(const vector<Lit>& cands, vector<char>& dropped) const
+{
+    vector<char> critical(nVars(), 0);
+    for(auto const& off: longIrredCls) {
+        const Clause& cl = *cl_alloc.ptr(off);
+        uint32_t num_true = 0;
+        Lit last_true = lit_Undef;
+        for(auto const& l: cl) {
+            if ((model[l.var()] ^ l.sign()) == l_True) {
+                num_true++;
+                last_true = l;
+            }
+        }
+        if (num_true == 1) critical[last_true.var()] = 1;
+    }
+    for(uint32_t i = 0; i < nVars()*2; i++) {
+        const Lit l1 = Lit::toLit(i);
+        for(auto const& w: watches[l1]) {
+            if (!w.isBin() || w.red()) continue;
+            const Lit l2 = w.lit2();
+            if (l1 > l2) continue;
+            const bool t1 = (model[l1.var()] ^ l1.sign()) == l_True;
+            const bool t2 = (model[l2.var()] ^ l2.sign()) == l_True;
+            if (t1 && !t2) critical[l1.var()] = 1;
+            if (t2 && !t1) critical[l2.var()] = 1;
+        }
+    }
+    for(const Lit l: cands) if (!critical[l.var()]) dropped[l.var()] = 1;
+}
+
+//Backbone on our own engine: a first model gives the candidates, flipping
+//filters them, then every remaining candidate is refuted or confirmed with
+//its negation as the only assumption. Each new model drops the candidates
+//it disagrees with.
+bool Solver::backbone_native(int64_t orig_max_confl, bool& finished)
+{
+    assert(okay());
+    assert(decisionLevel() == 0);
+    const double my_time = cpuTime();
+    const uint64_t max_confl = orig_max_confl*conf.global_timeout_multiplier;
+    const uint64_t confl_start = sumConflicts;
+    uint32_t num_flip_dropped = 0;
+    uint32_t num_model_dropped = 0;
+    uint32_t num_checks = 0;
+    uint32_t num_units = 0;
+    uint32_t num_undecided = 0;
+    bool out_of_budget = false;
+    vector<Lit> cands;
+
+    //The backbone is that of the CNF alone, not under the user's assumptions
+    const vector<Lit> user_assumptions = assumptions;
+    unfill_assumptions_set();
+    assumptions.clear();
+
+    //Inprocessing may have left variables out of the branching heaps
+    rebuildOrderHeap();
+    lbool ret = backbone_search(max_confl);
+    if (ret != l_True) {
+        out_of_budget = true;
+        goto end;
+    }
+
+    {
+        for(uint32_t v = 0; v < nVars(); v++) {
+            if (value(v) != l_Undef || varData[v].removed != Removed::none) continue;
+            if (model[v] == l_Undef) continue;
+            cands.push_back(Lit(v, model[v] == l_False));
+        }
+        vector<char> dropped(nVars(), 0);
+        backbone_flip_filter(cands, dropped);
+        for(const Lit l: cands) num_flip_dropped += dropped[l.var()];
+
+        for(uint32_t i = 0; i < cands.size(); i++) {
+            const Lit l = cands[i];
+            if (dropped[l.var()] || value(l) != l_Undef) continue;
+            const uint64_t used = sumConflicts - confl_start;
+            if (used >= max_confl || must_interrupt_asap()) {
+                out_of_budget = true;
+                break;
+            }
+
+            num_checks++;
+            assumptions.push_back(map_inter_to_outer(~l));
+            ret = backbone_search(std::min<uint64_t>(max_confl-used, 2000));
+            assumptions.clear();
+            if (!okay()) goto end;
+
+            if (ret == l_False) {
+                if (value(l) == l_Undef) {
+                    vector<Lit> tmp{l};
+                    add_clause_int(tmp);
+                    if (!okay()) goto end;
+                }
+                num_units++;
+            } else if (ret == l_True) {
+                for(uint32_t j = i+1; j < cands.size(); j++) {
+                    const Lit l2 = cands[j];
+                    if (!dropped[l2.var()] && (model[l2.var()] ^ l2.sign()) != l_True) {
+                        dropped[l2.var()] = 1;
+                        num_model_dropped++;
+                    }
+                }
+            } else {
+                num_undecided++;
+            }
+        }
+    }
+
+    end:
+    conflict.clear();
+    assumptions = user_assumptions;
+    if (okay()) fill_assumptions_set();
+    finished = okay() && !out_of_budget && num_undecided == 0;
+
+    verb_print(1, "[backbone] cands: " << cands.size()
+        << " flip-dropped: " << num_flip_dropped
+        << " model-dropped: " << num_model_dropped
+        << " checks: " << num_checks
+        << " units: " << num_units
+        << " undecided: " << num_undecided
+        << " confl: " << (sumConflicts - confl_start)
+        << " finished: " << finished
+        << conf.print_times(cpuTime() - my_time));
+    return okay();
+}
+
 void Solver::detach_and_free_all_irred_cls()
 {
     for(auto& ws: watches) {
@@ -0,0 +1,195 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+// Converts DIMACS (possibly compressed) to the binary CNF format, and back.
+// Usage: cryptominisat5_bcnf INPUT OUTPUT
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <sstream>
+#include <iostream>
+
+#include "dimacsparser.h"
+#include "inputcodec.h"
+#include "binarycnf.h"
+
+using namespace CMSat;
+using std::string;
+
+// Takes the place of the solver in DimacsParser, and writes out whatever
+// is added to it, either in binary or in DIMACS
+class ConvertSink
+{
+public:
+    explicit ConvertSink(BinaryCnfWriter* _writer) : writer(_writer) {}
+
+    uint32_t nVars() const { return num_vars; }
+    void new_vars(const uint32_t n) {
+        num_vars += n;
+        if (writer) writer->set_num_vars(num_vars);
+    }
+    void new_var() { new_vars(1); }
+
+    bool add_clause(const vector<Lit>& lits) {
+        if (writer) writer->add_clause(lits);
+        else if (lits.empty()) text << "0\n";
+        else text << lits << " 0\n";
+        num_cls++;
+        return true;
+    }
+    bool add_clauses(const vector<Lit>& lits) {
+        tmp.clear();
+        for(const Lit l: lits) {
+            if (l == lit_Undef) {
+                add_clause(tmp);
+                tmp.clear();
+            } else {
+                tmp.push_back(l);
+            }
+        }
+        return true;
+    }
+    bool add_red_clause(const vector<Lit>& lits) {
+        if (writer) writer->add_clause(lits, true);
+        else text << "c red " << lits << " 0\n";
+        return true;
+    }
+    bool add_xor_clause(const vector<Lit>& lits, bool rhs) {
+        vars.clear();
+        for(const Lit l: lits) {
+            vars.push_back(l.var());
+            rhs ^= l.sign();
+        }
+        if (writer) {
+            writer->add_xor_clause(vars, rhs);
+        } else {
+            text << "x ";
+            for(uint32_t i = 0; i < vars.size(); i++) {
+                text << ((i == 0 && !rhs) ? "-" : "") << vars[i]+1 << " ";
+            }
+            text << "0\n";
+        }
+        num_cls++;
+        return true;
+    }
+    #ifdef ENABLE_BNN
+    void add_bnn_clause(const vector<Lit>& lits, const int32_t cutoff, const Lit out) {
+        if (writer) writer->add_bnn_clause(lits, cutoff, out);
+        else {
+            text << "b " << lits << " 0 " << cutoff;
+            if (out != lit_Undef) text << " " << out;
+            text << "\n";
+        }
+    }
+    #endif
+    void set_sampl_vars(const vector<uint32_t>& v) { sampl(v, false); }
+    void set_opt_sampl_vars(const vector<uint32_t>& v) { sampl(v, true); }
+    void set_weighted(const bool) {}
+    void set_lit_weight(const Lit lit, const double weight) {
+        if (writer) writer->set_lit_weight(lit, weight);
+        else text << "c p weight " << lit << " " << weight << " 0\n";
+    }
+    void set_multiplier_weight(const mpz_class&) {
+        std::cerr << "WARNING: 'c MUST MULTIPLY BY' is not supported, dropping it" << std::endl;
+    }
+
+    // DIMACS output needs the header before the body
+    bool write_text(FILE* f) const {
+        const string body = text.str();
+        return fprintf(f, "p cnf %u %llu\n", num_vars, (unsigned long long)num_cls) > 0
+            && fwrite(body.data(), 1, body.size(), f) == body.size();
+    }
+
+private:
+    void sampl(const vector<uint32_t>& v, const bool opt) {
+        if (writer) {
+            writer->set_sampl_vars(v, opt);
+            return;
+        }
+        text << (opt ? "c p optshow " : "c p show ");
+        for(const uint32_t x: v) text << x+1 << " ";
+        text << "0\n";
+    }
+
+    BinaryCnfWriter* writer;
+    std::stringstream text;
+    uint32_t num_vars = 0;
+    uint64_t num_cls = 0;
+    vector<Lit> tmp;
+    vector<uint32_t> vars;
+};
+
+static bool input_is_binary(const string& fname)
+{
+    FILE* f = fopen(fname.c_str(), "rb");
+    if (f == nullptr) return false;
+    char magic[8];
+    const size_t num = fread(magic, 1, 8, f);
+    fclose(f);
+    return is_binary_cnf(magic, num);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        std::cerr
+        << "Usage: " << argv[0] << " INPUT OUTPUT" << std::endl
+        << "Converts DIMACS CNF (possibly gzip or xz compressed) to binary CNF,"
+        << " and binary CNF back to DIMACS" << std::endl;
+        return -1;
+    }
+    const string in_fname = argv[1];
+    const string out_fname = argv[2];
+    const bool to_text = input_is_binary(in_fname);
+
+    std::unique_ptr<InputCodec> codec = open_input_codec(in_fname);
+    if (codec == nullptr) {
+        std::cerr << "ERROR! Could not open file '" << in_fname
+        << "' for reading: " << strerror(errno) << std::endl;
+        return -1;
+    }
+    FILE* out = fopen(out_fname.c_str(), "wb");
+    if (out == nullptr) {
+        std::cerr << "ERROR! Could not open file '" << out_fname
+        << "' for writing: " << strerror(errno) << std::endl;
+        return -1;
+    }
+
+    bool ok;
+    {
+        std::unique_ptr<BinaryCnfWriter> writer;
+        if (!to_text) writer.reset(new BinaryCnfWriter(out));
+        ConvertSink sink(writer.get());
+        PipelinedInput in(std::move(codec));
+        DimacsParser<StreamBuffer<PipelinedInput*, PIPE>, ConvertSink> parser(&sink, nullptr, 0);
+        ok = parser.parse_DIMACS(&in, false) && !in.error();
+        if (ok) ok = to_text ? sink.write_text(out) : writer->finish();
+    }
+    if (fclose(out) != 0) ok = false;
+    if (!ok) {
+        std::cerr << "ERROR! Conversion of '" << in_fname << "' failed" << std::endl;
+        return -1;
+    }
+    return 0;
+}
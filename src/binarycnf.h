@@ -0,0 +1,421 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#pragma once
+
+/*
+Binary CNF format ("BCNF")
+
+  magic      8 bytes: 0x7f 'B' 'C' 'N' 'F' version 0x00 0x00
+  num_vars   uint64, little endian
+  num_cls    uint64, little endian -- normal and redundant clauses
+  num_lits   uint64, little endian -- literals in those clauses
+  num_xors   uint64, little endian
+  records, each starting with a tag byte:
+    'C' clause           varint size, literals
+    'R' redundant clause varint size, literals
+    'X' XOR constraint   varint size, byte rhs, variables
+    'B' BNN constraint   varint size, literals, zigzag varint cutoff,
+                         varint output (0 = none, otherwise Lit::toInt()+1)
+    'S' sampling set     varint size, variables
+    'O' opt sampling set varint size, variables
+    'W' literal weight   varint Lit::toInt(), IEEE double, little endian
+    'E' end of file
+
+Literals (as Lit::toInt()) and variables are sorted, then delta-encoded
+as LEB128 varints. As with DIMACS, variables are created as they are
+encountered. The header counts are only hints: they are capped when used to
+reserve memory, and num_vars only adds variables that appear in no
+constraint once the other counts have been checked against what was read.
+A writer that cannot seek leaves all counts at 0.
+*/
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include "solvertypesmini.h"
+
+namespace CMSat {
+
+static const unsigned char bcnf_magic[8] = {0x7f, 'B', 'C', 'N', 'F', 1, 0, 0};
+static const size_t bcnf_header_size = 8 + 4*8;
+
+inline bool is_binary_cnf(const char* data, const size_t sz)
+{
+    return sz >= 8 && memcmp(data, bcnf_magic, 8) == 0;
+}
+
+class BinaryCnfWriter
+{
+public:
+    // Counts in the header are filled in by finish(), so "f" must be
+    // seekable for them to be correct
+    explicit BinaryCnfWriter(FILE* _f) :
+        f(_f)
+        , buf(bcnf_header_size, 0)
+    {
+        for(size_t i = 0; i < sizeof(bcnf_magic); i++) buf[i] = bcnf_magic[i];
+    }
+
+    ~BinaryCnfWriter()
+    {
+        if (!finished) finish();
+    }
+
+    // Variables are counted from the constraints, this is only needed for
+    // variables that appear in none of them
+    void set_num_vars(const uint64_t n) { num_vars = std::max(num_vars, n); }
+
+    void add_clause(const std::vector<Lit>& lits, const bool red = false)
+    {
+        buf.push_back(red ? 'R' : 'C');
+        write_lits(lits);
+        num_cls++;
+        num_lits += lits.size();
+    }
+
+    void add_xor_clause(const std::vector<uint32_t>& vars, const bool rhs)
+    {
+        buf.push_back('X');
+        write_varint(vars.size());
+        buf.push_back(rhs);
+        write_sorted(vars);
+        if (!vars.empty()) set_num_vars((uint64_t)tmp.back() + 1);
+        num_xors++;
+    }
+
+    void add_bnn_clause(const std::vector<Lit>& lits, const int32_t cutoff, const Lit out)
+    {
+        buf.push_back('B');
+        write_lits(lits);
+        write_varint(((uint32_t)cutoff << 1) ^ (uint32_t)(cutoff >> 31));
+        write_varint(out == lit_Undef ? 0 : (uint64_t)out.toInt()+1);
+        if (out != lit_Undef) set_num_vars((uint64_t)out.var() + 1);
+    }
+
+    void set_sampl_vars(const std::vector<uint32_t>& vars, const bool opt = false)
+    {
+        buf.push_back(opt ? 'O' : 'S');
+        write_varint(vars.size());
+        write_sorted(vars);
+    }
+
+    void set_lit_weight(const Lit lit, const double weight)
+    {
+        buf.push_back('W');
+        write_varint(lit.toInt());
+        uint64_t bits;
+        memcpy(&bits, &weight, 8);
+        for(int i = 0; i < 8; i++) buf.push_back((bits >> (8*i)) & 0xff);
+    }
+
+    // Returns false on I/O error
+    bool finish()
+    {
+        finished = true;
+        buf.push_back('E');
+        if (!flush()) return false;
+        if (fseek(f, 8, SEEK_SET) != 0) return true; //not seekable, counts stay 0
+        unsigned char hdr[32];
+        const uint64_t vals[4] = {num_vars, num_cls, num_lits, num_xors};
+        for(int i = 0; i < 4; i++) {
+            for(int j = 0; j < 8; j++) hdr[i*8+j] = (vals[i] >> (8*j)) & 0xff;
+        }
+        return fwrite(hdr, 1, 32, f) == 32 && fflush(f) == 0;
+    }
+
+private:
+    void write_varint(uint64_t x)
+    {
+        while (x >= 0x80) {
+            buf.push_back((unsigned char)(x | 0x80));
+            x >>= 7;
+        }
+        buf.push_back((unsigned char)x);
+        if (buf.size() >= (1U << 20)) flush();
+    }
+
+    void write_sorted(const std::vector<uint32_t>& vals)
+    {
+        tmp.assign(vals.begin(), vals.end());
+        std::sort(tmp.begin(), tmp.end());
+        uint32_t prev = 0;
+        for(const uint32_t v: tmp) {
+            write_varint(v - prev);
+            prev = v;
+        }
+    }
+
+    void write_lits(const std::vector<Lit>& lits)
+    {
+        write_varint(lits.size());
+        tmp.clear();
+        for(const Lit l: lits) tmp.push_back(l.toInt());
+        std::sort(tmp.begin(), tmp.end());
+        uint32_t prev = 0;
+        for(const uint32_t v: tmp) {
+            write_varint(v - prev);
+            prev = v;
+        }
+        if (!tmp.empty()) set_num_vars((uint64_t)(tmp.back() >> 1) + 1);
+    }
+
+    bool flush()
+    {
+        const bool ok = fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+        buf.clear();
+        return ok;
+    }
+
+    FILE* f;
+    std::vector<unsigned char> buf;
+    std::vector<uint32_t> tmp;
+    uint64_t num_vars = 0;
+    uint64_t num_cls = 0;
+    uint64_t num_lits = 0;
+    uint64_t num_xors = 0;
+    bool finished = false;
+};
+
+// Reads a binary CNF from memory into "solver", the same way DimacsParser
+// would read the corresponding DIMACS file
+template<class S>
+class BinaryCnfReader
+{
+public:
+    explicit BinaryCnfReader(S* _solver) :
+        solver(_solver)
+    {}
+
+    // With strict_header, constraints on variables beyond the header's
+    // count and counts that do not match the contents are errors
+    bool parse(const char* data, const size_t sz, const uint32_t offset_vars = 0,
+               const bool strict_header = false)
+    {
+        start = at = (const unsigned char*)data;
+        end = at + sz;
+        if (!is_binary_cnf(data, sz) || sz < bcnf_header_size) {
+            return error("not a binary CNF file");
+        }
+        at += 8;
+        uint64_t hdr[4];
+        for(int i = 0; i < 4; i++) {
+            hdr[i] = 0;
+            for(int j = 0; j < 8; j++) hdr[i] |= (uint64_t)*at++ << (8*j);
+        }
+        if (hdr[0] >= (1ULL << 28)) return error("too many variables in header");
+        const uint64_t header_vars = hdr[0] + offset_vars;
+        uint64_t num_cls = 0;
+        uint64_t num_lits = 0;
+        uint64_t num_xors = 0;
+
+        const size_t batch_limit = 1U << 22;
+        batch.reserve(std::min<uint64_t>(hdr[1] + hdr[2], batch_limit) + 1);
+        for(;;) {
+            if (at >= end) return error("unexpected end of file");
+            const unsigned char tag = *at++;
+            switch (tag) {
+                case 'C': {
+                    if (!read_lits(lits, offset_vars)) return false;
+                    num_cls++;
+                    num_lits += lits.size();
+                    batch.insert(batch.end(), lits.begin(), lits.end());
+                    batch.push_back(lit_Undef);
+                    norm_clauses_added++;
+                    if (batch.size() >= batch_limit) flush_batch();
+                    break;
+                }
+                case 'R':
+                    if (!read_lits(lits, offset_vars)) return false;
+                    num_cls++;
+                    num_lits += lits.size();
+                    flush_batch();
+                    solver->add_red_clause(lits);
+                    break;
+                case 'X': {
+                    uint64_t n;
+                    if (!read_varint(n) || at >= end) return error("truncated XOR");
+                    const bool rhs = *at++;
+                    if (!read_vars(n, vars, offset_vars, true)) return false;
+                    lits.clear();
+                    for(const uint32_t v: vars) lits.push_back(Lit(v, false));
+                    flush_batch();
+                    solver->add_xor_clause(lits, rhs);
+                    xor_clauses_added++;
+                    num_xors++;
+                    break;
+                }
+                case 'B': {
+                    #ifdef ENABLE_BNN
+                    if (!read_lits(lits, offset_vars)) return false;
+                    uint64_t cutoff;
+                    uint64_t out;
+                    if (!read_varint(cutoff) || !read_varint(out)) return error("truncated BNN");
+                    Lit out_lit = lit_Undef;
+                    if (out != 0) {
+                        if (!ensure_var(((out-1) >> 1) + offset_vars + 1)) return false;
+                        out_lit = Lit::toLit(out-1 + 2*offset_vars);
+                    }
+                    flush_batch();
+                    solver->add_bnn_clause(lits,
+                        (int32_t)((cutoff >> 1) ^ (~(cutoff & 1) + 1)), out_lit);
+                    break;
+                    #else
+                    return error("BNN encountered but not enabled in parsing");
+                    #endif
+                }
+                case 'S':
+                case 'O': {
+                    uint64_t n;
+                    if (!read_varint(n)) return error("truncated variable list");
+                    if (!read_vars(n, vars, offset_vars, true)) return false;
+                    flush_batch();
+                    if (tag == 'S') solver->set_sampl_vars(vars);
+                    else solver->set_opt_sampl_vars(vars);
+                    break;
+                }
+                case 'W': {
+                    uint64_t l;
+                    if (!read_varint(l) || end - at < 8) return error("truncated weight");
+                    if ((l >> 1) + offset_vars >= (1ULL << 28)) return error("variable far too large");
+                    const Lit lit = Lit::toLit(l + 2*offset_vars);
+                    if (!ensure_var((uint64_t)lit.var() + 1)) return false;
+                    uint64_t bits = 0;
+                    for(int j = 0; j < 8; j++) bits |= (uint64_t)*at++ << (8*j);
+                    double w;
+                    memcpy(&w, &bits, 8);
+                    flush_batch();
+                    solver->set_weighted(true);
+                    solver->set_lit_weight(lit, w);
+                    break;
+                }
+                case 'E': {
+                    flush_batch();
+                    //Written without seeking back, no counts
+                    if (hdr[0] == 0 && hdr[1] == 0 && hdr[2] == 0 && hdr[3] == 0) return true;
+                    if (hdr[1] != num_cls || hdr[2] != num_lits || hdr[3] != num_xors) {
+                        //Then num_vars can't be trusted either
+                        if (strict_header) return error("header counts do not match the contents");
+                        return true;
+                    }
+                    if (strict_header && num_vars > header_vars) {
+                        return error("variable beyond the number of variables in the header");
+                    }
+                    return ensure_var(header_vars);
+                }
+                default:
+                    return error("unknown record type");
+            }
+        }
+    }
+
+    size_t norm_clauses_added = 0;
+    size_t xor_clauses_added = 0;
+
+private:
+    bool error(const char* what)
+    {
+        std::cerr << "ERROR! Binary CNF: " << what
+        << " at byte " << (size_t)(at - start) << std::endl;
+        return false;
+    }
+
+    bool ensure_var(const uint64_t n)
+    {
+        if (n <= num_vars) return true;
+        if (n > (1ULL << 28)) return error("variable far too large");
+        if (solver->nVars() < n) {
+            //Clauses added so far must not refer to new variables
+            flush_batch();
+            solver->new_vars(n - solver->nVars());
+        }
+        num_vars = n;
+        return true;
+    }
+
+    bool read_varint(uint64_t& x)
+    {
+        x = 0;
+        for(unsigned shift = 0; shift < 64; shift += 7) {
+            if (at >= end) return false;
+            const unsigned char c = *at++;
+            x |= (uint64_t)(c & 0x7f) << shift;
+            if (!(c & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool read_vars(const uint64_t n, std::vector<uint32_t>& out,
+                   const uint32_t offset, const bool create)
+    {
+        out.clear();
+        uint64_t v = 0;
+        for(uint64_t i = 0; i < n; i++) {
+            uint64_t d;
+            if (!read_varint(d)) return error("truncated variable list");
+            v += d;
+            if (v + offset >= (1ULL << 28)) return error("variable far too large");
+            out.push_back(v + offset);
+        }
+        if (create && !out.empty() && !ensure_var((uint64_t)out.back() + 1)) return false;
+        return true;
+    }
+
+    bool read_lits(std::vector<Lit>& out, const uint32_t offset)
+    {
+        uint64_t n;
+        if (!read_varint(n)) return error("truncated clause");
+        out.clear();
+        uint64_t v = 0;
+        for(uint64_t i = 0; i < n; i++) {
+            uint64_t d;
+            if (!read_varint(d)) return error("truncated clause");
+            v += d;
+            if ((v >> 1) + offset >= (1ULL << 28)) return error("variable far too large");
+            out.push_back(Lit::toLit(v + 2*offset));
+        }
+        if (!out.empty() && !ensure_var((uint64_t)out.back().var() + 1)) return false;
+        return true;
+    }
+
+    void flush_batch()
+    {
+        if (batch.empty()) return;
+        solver->add_clauses(batch);
+        batch.clear();
+    }
+
+    S* solver;
+    const unsigned char* start = nullptr;
+    const unsigned char* at = nullptr;
+    const unsigned char* end = nullptr;
+    uint64_t num_vars = 0;
+    std::vector<Lit> batch;
+    std::vector<Lit> lits;
+    std::vector<uint32_t> vars;
+};
+
+}
@@ -0,0 +1,96 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "solvertypes.h"
+
+namespace CMSat {
+
+// Solver-wide record of where the formula changed, so that inprocessing
+// steps can limit their work to the part that changed since their last run.
+// A step keeps the value of now() from the start of its last run, and asks
+// what changed since then. Level 0 assignments are not recorded here, they
+// are on the trail already.
+class ChangeJournal
+{
+public:
+    void new_vars(const size_t n)
+    {
+        at++;
+        bin_stamp.resize(bin_stamp.size()+2*n, at);
+    }
+
+    // A binary clause, redundant or not, was added or had a literal replaced
+    void touch_bin(const Lit lit1, const Lit lit2)
+    {
+        at++;
+        bin_stamp[lit1.toInt()] = at;
+        bin_stamp[lit2.toInt()] = at;
+        last_bin_at = at;
+    }
+
+    // Literals were renumbered, nothing recorded before can be trusted
+    void touch_all()
+    {
+        at++;
+        all_at = at;
+    }
+
+    uint64_t now() const
+    {
+        return at;
+    }
+
+    bool all_changed_since(const uint64_t since) const
+    {
+        return all_at > since;
+    }
+
+    bool bin_added_since(const uint64_t since) const
+    {
+        return last_bin_at > since;
+    }
+
+    void bin_lits_since(const uint64_t since, const uint32_t nVars, vector<Lit>& out) const
+    {
+        out.clear();
+        for(uint32_t i = 0; i < nVars*2; i++) {
+            if (bin_stamp[i] > since) out.push_back(Lit::toLit(i));
+        }
+    }
+
+    size_t mem_used() const
+    {
+        return bin_stamp.capacity()*sizeof(uint64_t);
+    }
+
+private:
+    uint64_t at = 0;
+    uint64_t all_at = 0;
+    uint64_t last_bin_at = 0;
+    vector<uint64_t> bin_stamp; ///<Indexed by literal
+};
+
+}
@@ -237,6 +237,66 @@ void ClauseAllocator::move_one_watchlist(
     }
 }
 
+//Moves the irredundant and tier-0 clauses and queues the tier-1 ones, the
+//watches are updated by move_one_watchlist() afterwards
+void ClauseAllocator::move_hot_from_watchlist(
+    watch_subarray_const ws, ClOffset* newDataStart, ClOffset*& new_ptr
+    , vector<Clause*>& tier1)
+{
+    for(const Watched& w: ws) {
+        if (!w.isClause()) continue;
+        Clause* old = ptr(w.get_offset());
+        assert(!old->freed());
+        if (old->reloced) continue;
+        if (!old->red() || old->stats.which_red_array == 0) {
+            move_cl(newDataStart, new_ptr, old);
+        } else if (old->stats.which_red_array == 1) {
+            tier1.push_back(old);
+        }
+    }
+}
+
+//Literals in the order their watchlists are likely visited, hottest first.
+//With clause use stats, by the propagations made by the clauses watched.
+//Otherwise by the branching activity of the variable, with the literal that
+//is false under the saved phase first, as its watchlist is the one visited.
+vector<Lit> ClauseAllocator::lits_by_heat(const Solver* solver)
+{
+    struct Heat {
+        double h;
+        bool visited_first;
+        Lit lit;
+    };
+    vector<Heat> heat;
+    heat.reserve(solver->nVars()*2);
+    for(uint32_t v = 0; v < solver->nVars(); v++) {
+        for(uint32_t sign = 0; sign < 2; sign++) {
+            const Lit l(v, sign);
+            #if defined(STATS_NEEDED) || defined (FINAL_PREDICTOR) || defined(NORMAL_CL_USE_STATS)
+            double h = 0;
+            for(const Watched& w: solver->watches[l]) {
+                if (w.isClause()) h += ptr(w.get_offset())->stats.props_made;
+            }
+            #else
+            double h = solver->branch_strategy == branch::vsids
+                ? solver->var_act_vsids[v] : (double)solver->vmtf_btab[v];
+            #endif
+            const bool visited_first = l.sign() == (bool)solver->varData[v].saved_polarity;
+            heat.push_back(Heat{h, visited_first, l});
+        }
+    }
+    std::sort(heat.begin(), heat.end(), [](const Heat& a, const Heat& b) {
+        if (a.h != b.h) return a.h > b.h;
+        if (a.visited_first != b.visited_first) return a.visited_first;
+        return a.lit < b.lit;
+    });
+
+    vector<Lit> lits;
+    lits.reserve(heat.size());
+    for(const auto& h: heat) lits.push_back(h.lit);
+    return lits;
+}
+
 /**
 @brief If needed, compacts stacks, removing unused clauses
 
@@ -274,7 +334,15 @@ void ClauseAllocator::consolidate(
 
     assert(sizeof(BASE_DATA_TYPE) % sizeof(Lit) == 0);
 
-    vector<bool> visited(solver->watches.size(), 0);
+    if (solver->conf.consolidate_by_tier) {
+        //Hot clauses packed together at the start, then tier-1 ones
+        vector<Clause*> tier1;
+        for(const Lit l: lits_by_heat(solver)) {
+            move_hot_from_watchlist(solver->watches[l], newDataStart, new_ptr, tier1);
+        }
+        //Watched twice, so it may be in twice
+        for(Clause* old: tier1) if (!old->reloced) move_cl(newDataStart, new_ptr, old);
+    }
     for(auto& ws: solver->watches) {
         move_one_watchlist(ws, newDataStart, new_ptr);
     }
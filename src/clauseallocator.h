@@ -95,6 +95,10 @@ class ClauseAllocator {
         );
         void move_one_watchlist(
             watch_subarray& ws, ClOffset* newDataStart, ClOffset*& new_ptr);
+        void move_hot_from_watchlist(
+            watch_subarray_const ws, ClOffset* newDataStart, ClOffset*& new_ptr
+            , vector<Clause*>& tier1);
+        vector<Lit> lits_by_heat(const Solver* solver);
 
         ClOffset move_cl(
             ClOffset* newDataStart
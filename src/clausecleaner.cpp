@@ -97,6 +97,35 @@ void ClauseCleaner::clean_implicit_watchlist(
     watch_list.shrink_(i - j);
 }
 
+// Since the last cleaning, only binaries with a var set since, or binaries
+// added since, can need cleaning. The former are all in the watchlists of
+// the set var, and the other watchlist they are in is found through them.
+// Returns false if everything must be looked at.
+bool ClauseCleaner::collect_dirty_implicit()
+{
+    if (!solver->conf.inprocess_incremental
+        || !impl_cleaned_once
+        || impl_trail_at > solver->trail_size()
+        || solver->journal.all_changed_since(impl_journal_at)
+    ) {
+        return false;
+    }
+
+    assert(impl_dirty.getTouchedList().empty());
+    for(size_t i = impl_trail_at; i < solver->trail_size(); i++) {
+        const Lit set_lit = solver->trail_at(i);
+        for(const Lit lit: {set_lit, ~set_lit}) {
+            impl_dirty.touch(lit);
+            for(const Watched& w: solver->watches[lit]) {
+                if (w.isBin()) impl_dirty.touch(w.lit2());
+            }
+        }
+    }
+    solver->journal.bin_lits_since(impl_journal_at, solver->nVars(), impl_tmp);
+    impl_dirty.touch(impl_tmp);
+    return true;
+}
+
 void ClauseCleaner::clean_implicit_clauses()
 {
     if (solver->conf.verbosity > 15) {
@@ -105,25 +134,37 @@ void ClauseCleaner::clean_implicit_clauses()
 
     assert(solver->decisionLevel() == 0);
     impl_data = ImplicitData();
-    size_t wsLit = 0;
-    size_t wsLit2 = 2;
-    for (size_t end = solver->watches.size()
-        ; wsLit != end
-        ; wsLit++, wsLit2++
-    ) {
-        if (wsLit2 < end
-            && !solver->watches[Lit::toLit(wsLit2)].empty()
-        ) {
-            solver->watches.prefetch(Lit::toLit(wsLit2).toInt());
+    if (collect_dirty_implicit()) {
+        for(const uint32_t at: impl_dirty.getTouchedList()) {
+            const Lit lit = Lit::toLit(at);
+            watch_subarray ws = solver->watches[lit];
+            if (!ws.empty()) clean_implicit_watchlist(ws, lit);
         }
+        impl_dirty.clear();
+    } else {
+        size_t wsLit = 0;
+        size_t wsLit2 = 2;
+        for (size_t end = solver->watches.size()
+            ; wsLit != end
+            ; wsLit++, wsLit2++
+        ) {
+            if (wsLit2 < end
+                && !solver->watches[Lit::toLit(wsLit2)].empty()
+            ) {
+                solver->watches.prefetch(Lit::toLit(wsLit2).toInt());
+            }
 
-        const Lit lit = Lit::toLit(wsLit);
-        watch_subarray ws = solver->watches[lit];
-        if (ws.empty())
-            continue;
+            const Lit lit = Lit::toLit(wsLit);
+            watch_subarray ws = solver->watches[lit];
+            if (ws.empty())
+                continue;
 
-        clean_implicit_watchlist(ws, lit);
+            clean_implicit_watchlist(ws, lit);
+        }
     }
+    impl_cleaned_once = true;
+    impl_trail_at = solver->trail_size();
+    impl_journal_at = solver->journal.now();
     impl_data.update_solver_stats(solver);
 
     #ifdef DEBUG_IMPLICIT_STATS
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "watcharray.h"
 #include "clause.h"
 #include "xor.h"
+#include "touchlist.h"
 #include <vector>
 using std::vector;
 
@@ -66,6 +67,15 @@ class ClauseCleaner
             void update_solver_stats(Solver* solver);
         };
         ImplicitData impl_data;
+
+        //Incremental implicit cleaning, see conf.inprocess_incremental
+        bool impl_cleaned_once = false;
+        size_t impl_trail_at = 0;
+        uint64_t impl_journal_at = 0;
+        TouchListLit impl_dirty;
+        vector<Lit> impl_tmp;
+        bool collect_dirty_implicit();
+
         void clean_implicit_watchlist(
             watch_subarray& watch_list
             , const Lit lit
@@ -671,6 +671,10 @@ void CNF::add_frat(FILE* os) {
     if (frat) delete frat;
     frat = new FratFile<false>(inter_to_outerMain);
     frat->setFile(os);
+    if (!frat->set_gzip(conf.proof_gzip_level)) {
+        std::cerr << "ERROR: compressed proof output is not available in this build" << endl;
+        exit(-1);
+    }
     frat->set_sumconflicts_ptr(&sumConflicts);
     frat->set_sqlstats_ptr(sqlStats);
 }
@@ -679,6 +683,10 @@ void CNF::add_idrup(FILE* os) {
     if (frat) delete frat;
     frat = new IdrupFile<false>(inter_to_outerMain);
     frat->setFile(os);
+    if (!frat->set_gzip(conf.proof_gzip_level)) {
+        std::cerr << "ERROR: compressed proof output is not available in this build" << endl;
+        exit(-1);
+    }
     frat->set_sumconflicts_ptr(&sumConflicts);
     frat->set_sqlstats_ptr(sqlStats);
 }
@@ -286,10 +286,8 @@ public:
     void check_no_duplicate_lits_anywhere() const;
     void check_no_zero_ID_bins() const;
 
-#ifdef ARJUN_SERIALIZE
     template<class T> void unserialize(T& ar);
     template<class T> void serialize(T& ar) const;
-#endif
     size_t get_num_long_cls() const;
     size_t get_num_long_irred_cls() const;
     size_t get_num_long_red_cls() const;
@@ -712,18 +710,14 @@ inline int32_t CNF::clean_xor_vars_no_prop(vector<Lit>& ps, bool& rhs, int32_t X
     return XID;
 }
 
-#ifdef ARJUN_SERIALIZE
 template<class T> void CNF::unserialize(T& ar)
 {
-    ar >> outer_to_with_bva_map;
     ar >> num_bva_vars;
 }
 
 template<class T> void CNF::serialize(T& ar) const
 {
-    ar << outer_to_with_bva_map;
     ar << num_bva_vars;
 }
-#endif
 
 }
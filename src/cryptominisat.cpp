@@ -23,9 +23,11 @@ THE SOFTWARE.
 #include "constants.h"
 #include "cryptominisat.h"
 #include "solver.h"
+#include "serializer.h"
 #include "frat.h"
 #include "shareddata.h"
 #include "solvertypesmini.h"
+#include "binarycnf.h"
 
 #include <fstream>
 #include <cstdint>
@@ -70,6 +72,7 @@ namespace CMSat {
 
             delete log; //this will also close the file
             delete shared_data;
+            delete tracer; //after the solvers, they flush into it
         }
         CMSatPrivateData(const CMSatPrivateData&) = delete;
         CMSatPrivateData& operator=(const CMSatPrivateData&) = delete;
@@ -85,6 +88,7 @@ namespace CMSat {
 
         ///????
         std::ofstream* log = nullptr;
+        Tracer* tracer = nullptr;
         int sql = 0;
         double timeout = numeric_limits<double>::max();
         bool interrupted = false;
@@ -97,6 +101,19 @@ namespace CMSat {
         unsigned total_num_vars = 0;
         vector<Lit> cls_lits;
 
+        //Clause groups, indexed by group number
+        struct ClauseGroup {
+            uint32_t var;
+            bool enabled = true;
+            bool dropped = false;
+        };
+        vector<ClauseGroup> clause_groups;
+        vector<char> is_group_var;
+        uint32_t num_live_groups = 0;
+        bool groups_dropped = false;
+        vector<Lit> tmp_group_cl;
+        vector<Lit> assumps_with_groups;
+
         //For single call setup
         uint32_t num_solve_simplify_calls = 0;
         bool promised_single_call = false;
@@ -406,6 +423,12 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
         throw std::runtime_error(err);
     }
 
+    if (data->solvers[0]->ext_prop) {
+        const char err[] = "ERROR: External propagator cannot be used in multi-threaded mode";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+
     if (data->cls > 0 || nVars() > 0) {
         const char err[] = "ERROR: You must first call set_num_threads() and only then add clauses and variables";
         std::cerr << err << endl;
@@ -425,6 +448,7 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
         update_config(conf, i);
         data->solvers.push_back(new Solver(&conf, data->must_interrupt));
         data->cpu_times.push_back(0.0);
+        if (data->tracer) data->solvers.back()->set_tracer(data->tracer);
     }
 
     //set shared data
@@ -435,6 +459,7 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
             conf.verbosity = 0;
             conf.doFindXors = 0;
         }
+        conf.mem_budget_share = 1.0/num;
         data->solvers[i]->setConf(conf);
         data->solvers[i]->set_shared_data((SharedData*)data->shared_data);
     }
@@ -718,6 +743,56 @@ DLL_PUBLIC bool SATSolver::add_clause(const vector< Lit >& lits)
     return ret;
 }
 
+DLL_PUBLIC bool SATSolver::add_clauses(const vector<Lit>& lits)
+{
+    if (data->log) {
+        for(const Lit l: lits) {
+            if (l == lit_Undef) (*data->log) << "0" << endl;
+            else (*data->log) << l << " ";
+        }
+    }
+
+    bool ret = true;
+    if (data->solvers.size() > 1) {
+        if (data->cls_lits.size() + lits.size() + 1 > CACHE_SIZE) {
+            ret = actually_add_clauses_to_threads(data);
+        }
+
+        //Cache uses lit_Undef as the clause *start* marker
+        bool at_start = true;
+        for(const Lit l: lits) {
+            if (at_start) {
+                data->cls_lits.push_back(lit_Undef);
+                at_start = false;
+            }
+            if (l == lit_Undef) {
+                at_start = true;
+                data->cls++;
+                continue;
+            }
+            data->cls_lits.push_back(l);
+        }
+    } else {
+        data->solvers[0]->new_vars(data->vars_to_add);
+        data->vars_to_add = 0;
+
+        vector<Lit> cl;
+        for(const Lit l: lits) {
+            if (l != lit_Undef) {
+                cl.push_back(l);
+                continue;
+            }
+            ret = data->solvers[0]->add_clause_outside(cl);
+            data->cls++;
+            cl.clear();
+            if (!ret) break;
+        }
+        assert((!ret || cl.empty()) && "Last clause must be terminated by lit_Undef");
+    }
+
+    return ret;
+}
+
 void add_xor_clause_to_log(const std::vector<unsigned>& vars, bool rhs, std::ofstream* file)
 {
     if (vars.empty()) {
@@ -881,6 +956,68 @@ struct OneThreadCalc
     bool only_sampling_solution;
 };
 
+//Satisfied clauses would otherwise only go at the next level-0 cleaning,
+//whenever that happens. One pass removes all groups dropped since the last call
+static void remove_dropped_clause_groups(CMSatPrivateData* data)
+{
+    if (!data->groups_dropped) return;
+    data->groups_dropped = false;
+
+    if (!actually_add_clauses_to_threads(data)) {
+        data->okay = false;
+        return;
+    }
+    for(Solver* s: data->solvers) {
+        if (!s->remove_satisfied_clauses()) data->okay = false;
+    }
+}
+
+//Enabled groups are switched on by their variable being FALSE, disabled
+//ones are switched off by it being TRUE
+static const vector<Lit>* add_group_assumptions(
+    CMSatPrivateData* data, const vector<Lit>* assumptions)
+{
+    if (data->num_live_groups == 0) return assumptions;
+
+    auto& assumps = data->assumps_with_groups;
+    assumps.clear();
+    if (assumptions) assumps = *assumptions;
+    for(const auto& g: data->clause_groups) {
+        if (g.dropped) continue;
+        assumps.push_back(Lit(g.var, g.enabled));
+    }
+    return &assumps;
+}
+
+static void remove_group_vars_from_conflict(CMSatPrivateData* data)
+{
+    if (data->num_live_groups == 0) return;
+
+    vector<Lit>& conflict = data->solvers[data->which_solved]->conflict;
+    uint32_t j = 0;
+    for(const Lit l: conflict) {
+        if (l.var() < data->is_group_var.size() && data->is_group_var[l.var()]) continue;
+        conflict[j++] = l;
+    }
+    conflict.resize(j);
+}
+
+//The library-level state that goes with the solver state in a checkpoint
+static string checkpoint_header(const CMSatPrivateData* data)
+{
+    OutArchive ar;
+    ar << data->total_num_vars << data->okay
+        << data->clause_groups << data->is_group_var
+        << data->num_live_groups << data->groups_dropped;
+    return ar.str();
+}
+
+static void update_checkpoint_header(CMSatPrivateData* data)
+{
+    if (data->solvers[0]->conf.checkpoint_fname.empty()) return;
+    data->solvers[0]->checkpoint_header = checkpoint_header(data);
+}
+
 lbool calc(
     const vector< Lit >* assumptions,
     Todo todo,
@@ -979,7 +1116,12 @@ DLL_PUBLIC lbool SATSolver::solve(const vector< Lit >* assumptions, bool only_sa
     data->previous_sum_propagations = get_sum_propagations();
     data->previous_sum_decisions = get_sum_decisions();
 
-    return calc(assumptions, Todo::todo_solve, data, only_sampling_solution);
+    remove_dropped_clause_groups(data);
+    update_checkpoint_header(data);
+    const lbool ret = calc(add_group_assumptions(data, assumptions),
+        Todo::todo_solve, data, only_sampling_solution);
+    if (ret == l_False) remove_group_vars_from_conflict(data);
+    return ret;
 }
 
 DLL_PUBLIC lbool SATSolver::simplify(const vector< Lit >* assumptions, const string* strategy)
@@ -1000,7 +1142,45 @@ DLL_PUBLIC lbool SATSolver::simplify(const vector< Lit >* assumptions, const str
     data->previous_sum_propagations = get_sum_propagations();
     data->previous_sum_decisions = get_sum_decisions();
 
-    return calc(assumptions, Todo::todo_simplify, data, false, strategy);
+    remove_dropped_clause_groups(data);
+    return calc(add_group_assumptions(data, assumptions),
+        Todo::todo_simplify, data, false, strategy);
+}
+
+DLL_PUBLIC lbool SATSolver::enumerate(
+    void* state,
+    bool (*found)(void* state, const std::vector<lbool>& model),
+    uint64_t limit,
+    const std::vector<uint32_t>* projection,
+    const std::vector<Lit>* assumptions)
+{
+    vector<Lit> ban;
+    for(uint64_t num = 0; num < limit;) {
+        const lbool ret = solve(assumptions);
+        if (ret != l_True) return ret;
+        num++;
+
+        const vector<lbool>& model = get_model();
+        if (!found(state, model) || num == limit) return l_True;
+
+        ban.clear();
+        if (projection) {
+            for(const uint32_t var: *projection) {
+                if (model[var] != l_Undef) ban.push_back(Lit(var, model[var] == l_False));
+            }
+        } else {
+            for(uint32_t var = 0; var < model.size(); var++) {
+                if (var < data->is_group_var.size() && data->is_group_var[var]) continue;
+                if (model[var] != l_Undef) ban.push_back(Lit(var, model[var] == l_False));
+            }
+        }
+
+        //All solvers have the same clauses by now, any of them will do
+        data->solvers[data->which_solved]->minimize_projected_model(ban);
+        for(Lit& l: ban) l = ~l;
+        add_clause(ban);
+    }
+    return l_True;
 }
 
 DLL_PUBLIC const vector< lbool >& SATSolver::get_model() const
@@ -1134,6 +1314,11 @@ DLL_PUBLIC void SATSolver::set_frat(FILE* os)
         exit(-1);
     }
 
+    if (data->solvers[0]->ext_prop) {
+        std::cerr << "ERROR: FRAT cannot be used with an external propagator" << endl;
+        exit(-1);
+    }
+
     data->solvers[0]->conf.doBreakid = false;
     data->solvers[0]->add_frat(os);
     data->solvers[0]->conf.do_hyperbin_and_transred = true;
@@ -1157,6 +1342,115 @@ DLL_PUBLIC void SATSolver::set_idrup(FILE* os)
     data->solvers[0]->conf.do_hyperbin_and_transred = true;
 }
 
+DLL_PUBLIC void SATSolver::set_learnt_clause_callback(
+    void* state,
+    void (*learn)(void* state, const std::vector<Lit>& cls),
+    uint32_t max_len)
+{
+    LearntExport exp;
+    if (learn) {
+        exp.state = state;
+        exp.learn = learn;
+        exp.max_len = max_len;
+    }
+    for(auto& s: data->solvers) {
+        s->flush_learnt_export();
+        s->learnt_export = exp;
+    }
+}
+
+DLL_PUBLIC uint32_t SATSolver::new_clause_group()
+{
+    new_var();
+    const uint32_t var = nVars()-1;
+    data->clause_groups.push_back(CMSatPrivateData::ClauseGroup{var});
+    if (data->is_group_var.size() <= var) data->is_group_var.resize(var+1, 0);
+    data->is_group_var[var] = 1;
+    data->num_live_groups++;
+    return data->clause_groups.size()-1;
+}
+
+DLL_PUBLIC bool SATSolver::add_clause_to_group(uint32_t group, const vector<Lit>& lits)
+{
+    assert(group < data->clause_groups.size());
+    const auto& g = data->clause_groups[group];
+    if (g.dropped) {
+        const char err[] = "ERROR: add_clause_to_group() called on a dropped group";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    data->tmp_group_cl = lits;
+    data->tmp_group_cl.push_back(Lit(g.var, false));
+    return add_clause(data->tmp_group_cl);
+}
+
+DLL_PUBLIC void SATSolver::set_clause_group_enabled(uint32_t group, bool enabled)
+{
+    assert(group < data->clause_groups.size());
+    data->clause_groups[group].enabled = enabled;
+}
+
+DLL_PUBLIC void SATSolver::drop_clause_group(uint32_t group)
+{
+    assert(group < data->clause_groups.size());
+    auto& g = data->clause_groups[group];
+    if (g.dropped) return;
+    g.dropped = true;
+    data->num_live_groups--;
+
+    //All clauses of the group are now satisfied at level 0
+    add_clause(vector<Lit>{Lit(g.var, false)});
+    data->groups_dropped = true;
+}
+
+DLL_PUBLIC uint32_t SATSolver::clause_group_var(uint32_t group) const
+{
+    assert(group < data->clause_groups.size());
+    return data->clause_groups[group].var;
+}
+
+DLL_PUBLIC void SATSolver::connect_propagator(ExternalPropagator* prop)
+{
+    if (data->solvers.size() > 1) {
+        const char err[] = "ERROR: External propagator cannot be used in multi-threaded mode";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    Solver& s = *data->solvers[0];
+    if (prop && s.frat->enabled()) {
+        const char err[] = "ERROR: External propagator cannot be used with FRAT";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+
+    s.ext_prop = prop;
+    if (prop) {
+        //BVA variables would shift the numbering seen by the propagator
+        s.conf.do_bva = false;
+    } else {
+        s.ext_observed.clear();
+        for(auto& vd: s.varData) vd.observed = 0;
+    }
+}
+
+DLL_PUBLIC void SATSolver::add_observed_var(uint32_t var)
+{
+    Solver& s = *data->solvers[0];
+    if (!s.ext_prop) {
+        const char err[] = "ERROR: You must call connect_propagator() before add_observed_var()";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    if (var >= nVars()) {
+        const char err[] = "ERROR: add_observed_var() called with unknown variable";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    s.new_vars(data->vars_to_add);
+    data->vars_to_add = 0;
+    s.add_observed_var(var);
+}
+
 DLL_PUBLIC void SATSolver::interrupt_asap()
 {
     data->must_interrupt->store(true, std::memory_order_relaxed);
@@ -1336,6 +1630,124 @@ DLL_PUBLIC vector<uint32_t> SATSolver::translate_sampl_set(
     return data->solvers[0]->translate_sampl_set(sampl_set);
 }
 
+namespace CMSat {
+    struct ExtendSetup {
+        std::atomic<bool> must_interrupt {false};
+        SolverConf conf;
+        Solver* solver = nullptr;
+        ~ExtendSetup() { delete solver; }
+    };
+}
+
+DLL_PUBLIC std::string SATSolver::serialize_solution_reconstruction_data() const
+{
+    return data->solvers[0]->serialize_solution_reconstruction_data();
+}
+
+DLL_PUBLIC void* SATSolver::create_extend_solution_setup(std::string& dat)
+{
+    ExtendSetup* setup = new ExtendSetup;
+    setup->conf.verbosity = 0;
+    setup->solver = new Solver(&setup->conf, &setup->must_interrupt);
+    if (!setup->solver->create_from_solution_reconstruction_data(dat)) {
+        delete setup;
+        return nullptr;
+    }
+    return setup;
+}
+
+DLL_PUBLIC std::pair<lbool, std::vector<lbool>> SATSolver::extend_solution(
+    void* s, const std::vector<lbool>& simp_sol)
+{
+    ExtendSetup* setup = (ExtendSetup*)s;
+    return setup->solver->extend_minimized_model(simp_sol);
+}
+
+DLL_PUBLIC void SATSolver::delete_extend_solution_setup(void* s)
+{
+    delete (ExtendSetup*)s;
+}
+
+DLL_PUBLIC vector<PhaseStats> SATSolver::get_phase_stats() const
+{
+    return data->solvers[data->which_solved]->get_phase_stats();
+}
+
+DLL_PUBLIC std::string SATSolver::get_phase_stats_json() const
+{
+    return Telemetry::to_json(get_phase_stats());
+}
+
+DLL_PUBLIC bool SATSolver::save_state(const std::string& fname)
+{
+    if (!actually_add_clauses_to_threads(data)) data->okay = false;
+    data->solvers[0]->checkpoint_header = checkpoint_header(data);
+    return data->solvers[0]->save_state_to_file(fname);
+}
+
+DLL_PUBLIC bool SATSolver::load_state(const std::string& fname)
+{
+    if (data->total_num_vars != 0
+        || data->solvers[0]->nVarsOuter() != 0
+        || !data->cls_lits.empty()
+    ) {
+        std::cerr << "ERROR: load_state() can only be called on a fresh solver" << endl;
+        exit(-1);
+    }
+
+    string header;
+    string state;
+    if (!Solver::read_state_file(fname, header, state)) return false;
+
+    uint32_t total_num_vars = 0;
+    bool okay = true;
+    InArchive har(header);
+    har >> total_num_vars >> okay
+        >> data->clause_groups >> data->is_group_var
+        >> data->num_live_groups >> data->groups_dropped;
+    if (har.failed() || !har.at_end()) return false;
+
+    for(Solver* s: data->solvers) {
+        InArchive ar(state);
+        if (!s->load_state(ar)) {
+            std::cerr << "ERROR: checkpoint '" << fname << "' is corrupt" << endl;
+            exit(-1);
+        }
+    }
+    data->total_num_vars = total_num_vars;
+    data->okay = okay && data->solvers[0]->okay();
+    return true;
+}
+
+DLL_PUBLIC void SATSolver::set_checkpoint(const std::string& fname, double every_secs)
+{
+    for (auto & solver : data->solvers) {
+        solver->conf.checkpoint_fname = fname;
+        solver->conf.checkpoint_every_secs = every_secs;
+    }
+}
+
+DLL_PUBLIC bool SATSolver::set_trace_file(const std::string& fname)
+{
+    Tracer* tracer = new Tracer(fname);
+    if (!tracer->ok()) {
+        delete tracer;
+        return false;
+    }
+    for (auto & solver : data->solvers) solver->set_tracer(tracer);
+    delete data->tracer;
+    data->tracer = tracer;
+    return true;
+}
+
+DLL_PUBLIC void SATSolver::set_mem_budget(uint64_t bytes)
+{
+    for (auto & solver : data->solvers) {
+        solver->conf.mem_budget_bytes = bytes;
+        solver->conf.mem_budget_share = 1.0/data->solvers.size();
+    }
+}
+
 void DLL_PUBLIC SATSolver::set_min_bva_gain(uint32_t min_bva_gain)
 {
     for (auto & solver : data->solvers) {
@@ -1493,6 +1905,13 @@ DLL_PUBLIC void SATSolver::set_renumber(const bool renumber)
     }
 }
 
+DLL_PUBLIC void SATSolver::set_renumber_order(const int order)
+{
+    for(auto& s: data->solvers) {
+        s->conf.renumber_order = order;
+    }
+}
+
 DLL_PUBLIC std::vector<uint32_t> SATSolver::remove_definable_by_irreg_gate(const vector<uint32_t>& vars)
 {
     return data->solvers[0]->remove_definable_by_irreg_gate(vars);
@@ -1681,6 +2100,55 @@ DLL_PUBLIC void SATSolver::open_file_and_dump_irred_clauses(const char* fname)
     }
 }
 
+DLL_PUBLIC void SATSolver::open_file_and_dump_irred_clauses_binary(const char* fname)
+{
+    FILE* f = fopen(fname, "wb");
+    if (f == nullptr) {
+        std::cerr
+        << "ERROR: Cannot open file '" << fname << "'"
+        << " for writing."
+        << endl;
+        exit(-1);
+    }
+
+    BinaryCnfWriter writer(f);
+    writer.set_num_vars(nVars());
+    start_getting_constraints(false);
+    vector<Lit> lits; bool is_xor; bool rhs;
+    vector<uint32_t> vars;
+    while (get_next_constraint(lits, is_xor, rhs)) {
+        if (is_xor) {
+            vars.clear();
+            for(const Lit l: lits) {
+                vars.push_back(l.var());
+                rhs ^= l.sign();
+            }
+            writer.add_xor_clause(vars, rhs);
+        } else {
+            writer.add_clause(lits);
+        }
+    }
+    end_getting_constraints();
+    if (get_sampl_vars_set()) writer.set_sampl_vars(get_sampl_vars());
+
+    //Not retrievable as constraints, the file would silently be a different problem
+    size_t num_bnns = 0;
+    for(const BNN* bnn: data->solvers[0]->get_bnns()) num_bnns += bnn != nullptr;
+    if (num_bnns > 0) {
+        std::cerr << "WARNING: " << num_bnns << " BNN constraint(s) are not written to '"
+        << fname << "', dropping them" << endl;
+    }
+    if (get_weighted()) {
+        std::cerr << "WARNING: literal weights are not written to '"
+        << fname << "', dropping them" << endl;
+    }
+
+    if (!writer.finish() || fclose(f) != 0) {
+        std::cerr << "ERROR: Cannot write file '" << fname << "'" << endl;
+        exit(-1);
+    }
+}
+
 DLL_PUBLIC void SATSolver::set_pred_short_size(int32_t sz)
 {
     if (sz == -1) {
@@ -1848,6 +2316,13 @@ DLL_PUBLIC void SATSolver::set_oracle_removed_is_learnt(bool val) {
     s.conf.oracle_removed_is_learnt = val;
 }
 
+DLL_PUBLIC void SATSolver::set_oracle_threads(uint32_t num) {
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.oracle_threads = num;
+    }
+}
+
 // Weight stuff
 DLL_PUBLIC bool SATSolver::get_weighted() const {
     const Solver& s = *data->solvers[0];
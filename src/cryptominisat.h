@@ -60,6 +60,7 @@ namespace CMSat {
         void new_vars(const size_t n); //and many new variables to the solver -- much faster
         unsigned nVars() const; //get number of variables inside the solver
         bool add_clause(const std::vector<Lit>& lits);
+        bool add_clauses(const std::vector<Lit>& lits); //many clauses in one go, each terminated by lit_Undef -- much faster
         bool add_red_clause(const std::vector<Lit>& lits);
         bool add_xor_clause(const std::vector<unsigned>& vars, bool rhs);
         bool add_xor_clause(const std::vector<Lit>& lits, bool rhs = true);
@@ -79,6 +80,17 @@ namespace CMSat {
         lbool simplify(const std::vector<Lit>* assumptions = nullptr, const std::string* strategy = nullptr); //simplify the problem, optionally with assumptions
         const std::vector<lbool>& get_model() const; //get model that satisfies the problem. Only makes sense if previous solve()/simplify() call was l_True
         const std::vector<Lit>& get_conflict() const; //get conflict in terms of the assumptions given in case the previous call to solve() was l_False
+        // Enumerates at most "limit" models, projected onto "projection" (all
+        // variables if nullptr), calling "found" with each. Stops early when
+        // "found" returns false. Each model is banned with a minimized
+        // blocking clause, added to the problem. Returns l_False once all
+        // models have been found, l_True if stopped early, l_Undef on timeout
+        lbool enumerate(
+            void* state,
+            bool (*found)(void* state, const std::vector<lbool>& model),
+            uint64_t limit,
+            const std::vector<uint32_t>* projection = nullptr,
+            const std::vector<Lit>* assumptions = nullptr);
         bool okay() const; //the problem is still solveable, i.e. the empty clause hasn't been derived
         const std::vector<Lit>& get_decisions_reaching_model() const; //get decisions that lead to model. may NOT work, in case the decisions needed were internal, extended variables. exit(-1)'s in case of such a case. you MUST check decisions_reaching_computed().
 
@@ -154,12 +166,14 @@ namespace CMSat {
         void set_max_red_linkin_size(uint32_t sz);
         void set_seed(const uint32_t seed);
         void set_renumber(const bool renumber);
+        void set_renumber_order(const int order); //0 = compact, 1 = BFS, 2 = Louvain communities
         void set_weaken_time_limitM(const uint32_t lim);
         void set_picosat_gate_limitK(const uint32_t lim);
         void set_occ_based_lit_rem_time_limitM(const uint32_t lim);
         void set_orig_global_timeout_multiplier(const double mult);
         void set_oracle_get_learnts(bool val);
         void set_oracle_removed_is_learnt(bool val);
+        void set_oracle_threads(uint32_t num);
         double get_orig_global_timeout_multiplier();
         bool minimize_clause(std::vector<Lit>& cl);
 
@@ -207,6 +221,33 @@ namespace CMSat {
         void set_frat(FILE* os); //set frat to ostream, e.g. stdout or a file
         void set_idrup(FILE* os); //set idrup to ostream, e.g. stdout or a file
         void add_empty_cl_to_frat(); // allows to treat SAT as UNSAT and perform learning
+
+        // Learnt clauses of size at most max_len are passed to "learn" in
+        // batches, each clause terminated by lit_Undef. With multiple threads
+        // "learn" is called from all of them concurrently. Pass nullptr to disable.
+        void set_learnt_clause_callback(
+            void* state,
+            void (*learn)(void* state, const std::vector<Lit>& cls),
+            uint32_t max_len);
+
+        // Clause groups. Each group is guarded by a fresh variable, returned by
+        // new_clause_group(). Groups are enabled at creation, and are only in
+        // effect for solve() while enabled. A dropped group's clauses, and the
+        // learnt clauses derived from them, are removed at the next
+        // solve()/simplify(). Conflicts returned are free of group variables.
+        uint32_t new_clause_group();
+        bool add_clause_to_group(uint32_t group, const std::vector<Lit>& lits);
+        void set_clause_group_enabled(uint32_t group, bool enabled);
+        void drop_clause_group(uint32_t group);
+        uint32_t clause_group_var(uint32_t group) const;
+
+        // External propagator, see ExternalPropagator. Single-threaded only,
+        // and cannot be combined with FRAT. Pass nullptr to disconnect.
+        // Observed variables are never eliminated. Connecting turns off BVA
+        // for good, as its new variables would shift the numbering seen by
+        // the propagator.
+        void connect_propagator(ExternalPropagator* prop);
+        void add_observed_var(uint32_t var);
         void interrupt_asap(); //call this asynchronously, and the solver will try to cleanly abort asap
         void add_in_partial_solving_stats(); //used only by Ctrl+C handler. Ignore.
 
@@ -260,15 +301,53 @@ namespace CMSat {
         uint32_t simplified_nvars();
         std::vector<uint32_t> translate_sampl_set(const std::vector<uint32_t>& sampl_set);
 
-        // Solution reconstruction after minimization
+        // Solution reconstruction after minimization. The data is only valid
+        // for the same build of the library. create_extend_solution_setup()
+        // returns nullptr if the data cannot be read back. extend_solution()
+        // takes a model of the simplified CNF (see simplified_nvars()) and
+        // returns a model of the original one
         std::string serialize_solution_reconstruction_data() const;
         static void* create_extend_solution_setup(std::string& data);
         static std::pair<lbool, std::vector<lbool>> extend_solution(void* s, const std::vector<lbool>& simp_sol);
         static void delete_extend_solution_setup(void* s);
 
+        // Per-phase telemetry of the solver that found the last result:
+        // time, propagations, memory and removed variables/literals for every
+        // simplification token, search iteration, ReduceDB call type and
+        // for Gauss-Jordan matrices. Always collected, cumulative over all
+        // calls to solve()/simplify()
+        std::vector<PhaseStats> get_phase_stats() const;
+        std::string get_phase_stats_json() const;
+
+        // Checkpointing. save_state() writes the full search state: clauses
+        // (learnt ones too), activities, phases and schedules, so that a
+        // solver calling load_state() continues close to where this one
+        // left off. load_state() must be called on a fresh solver, before
+        // anything is added. Both return false on failure, e.g. when FRAT
+        // is used or the file is from another build. set_checkpoint() makes
+        // solve() save the state every "every_secs" seconds.
+        bool save_state(const std::string& fname);
+        bool load_state(const std::string& fname);
+        void set_checkpoint(const std::string& fname, double every_secs = 600);
+
+        // Write a timeline of simplification, search, ReduceDB, data sharing
+        // and restart phases, one row per thread, in the Chrome trace event
+        // format. Open with chrome://tracing or ui.perfetto.dev. Returns
+        // false if the file cannot be created
+        bool set_trace_file(const std::string& fname);
+
+        // Limit the memory of the whole process to this many bytes. Close
+        // to the limit the solver cuts its learnt clause database and skips
+        // memory-hungry inprocessing. If that is not enough, solve() returns
+        // l_Undef. 0 means unlimited. In multi-threaded mode each thread gets
+        // an equal share
+        void set_mem_budget(uint64_t bytes);
+
         /////////////////////
         // Backwards compatibility, implemented using the above "small clauses" functions
         void open_file_and_dump_irred_clauses(const char* fname);
+        // Same, in the binary CNF format of binarycnf.h, with the sampling set
+        void open_file_and_dump_irred_clauses_binary(const char* fname);
         bool removed_var(uint32_t var) const;
 
 #ifdef WEIGHTED
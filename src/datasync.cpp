@@ -112,13 +112,17 @@ bool DataSync::syncData()
         return true;
     }
     numCalls++;
+    TraceSpan span(solver->trace, "sync");
 
     assert(sharedData != nullptr);
     assert(solver->decisionLevel() == 0);
 
     //SEND data
     bool ok;
-    sharedData->unit_mutex.lock();
+    {
+        TraceSpan wait(solver->trace, "sync-lock-wait");
+        sharedData->unit_mutex.lock();
+    }
     ok = shareUnitData();
     sharedData->unit_mutex.unlock();
     if (!ok) {
@@ -130,7 +134,10 @@ bool DataSync::syncData()
     }
 
     //RECEIVE data
-    sharedData->bin_mutex.lock();
+    {
+        TraceSpan wait(solver->trace, "sync-lock-wait");
+        sharedData->bin_mutex.lock();
+    }
     extend_bins_if_needed();
     clear_set_binary_values();
     ok = shareBinData();
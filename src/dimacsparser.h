@@ -25,6 +25,7 @@ THE SOFTWARE.
 
 #include <cstring>
 #include "streambuffer.h"
+#include "binarycnf.h"
 #include "solvertypesmini.h"
 #include <cstdlib>
 #include <cmath>
@@ -34,6 +35,10 @@ THE SOFTWARE.
 #include <iomanip>
 #include <vector>
 #include <cassert>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <gmpxx.h>
 
 using std::vector;
@@ -54,6 +59,18 @@ class DimacsParser
             T input_stpeam,
             const bool strict_header,
             uint32_t offset_vars = 0);
+
+        //Parses an in-memory DIMACS file (e.g. a memory-mapped one). Plain
+        //clause lines are tokenized by "num_threads" threads, everything else
+        //goes through the normal parser, in the order of the file. Only a few
+        //blocks per thread are tokenized ahead of the clauses being added, so
+        //memory use does not grow with the size of the file
+        bool parse_DIMACS_mem(
+            const char* start,
+            const char* end,
+            const bool strict_header,
+            uint32_t offset_vars = 0,
+            unsigned num_threads = 1);
         uint64_t max_var = numeric_limits<uint64_t>::max();
         map<int32_t, double> weights;
         const std::string dimacs_spec = "http://www.satcompetition.org/2009/format-benchmarks2009.html";
@@ -61,6 +78,29 @@ class DimacsParser
 
     private:
         bool parse_DIMACS_main(C& in);
+        bool parse_line(C& in);
+        void print_stats(const uint32_t origNumVars) const;
+        bool parse_binary(const char* start, const char* end, const uint32_t origNumVars);
+
+        //Result of tokenizing a part of the input in parallel. Each segment
+        //holds clauses terminated by lit_Undef, and possibly the line that
+        //follows it, which must be handed to the normal parser
+        struct MemSegment {
+            vector<Lit> lits;
+            size_t num_cls = 0;
+            uint32_t num_vars = 0; //largest variable + 1
+            const char* line_start = nullptr;
+            const char* line_end = nullptr;
+            size_t line_num = 0;
+        };
+        struct MemChunk {
+            vector<MemSegment> segs;
+            size_t num_lines = 0;
+            bool ready = false;
+        };
+        static constexpr size_t mem_block_size = 4*1024*1024;
+        void tokenize_chunk(const char* start, const char* end, MemChunk& chunk) const;
+        bool tokenize_line(const char* at, const char* eol, MemSegment& seg) const;
         bool readClause(C& in);
         bool parse_and_add_clause(C& in);
         bool parse_and_add_xor_clause(C& in);
@@ -596,65 +636,91 @@ bool DimacsParser<C, S>::parse_and_add_xor_clause(C& in)
 }
 
 template<class C, class S>
-bool DimacsParser<C, S>::parse_DIMACS_main(C& in)
+bool DimacsParser<C, S>::parse_line(C& in)
 {
     std::string str;
 
+    switch (*in) {
+    case 'p':
+        if (!parse_header(in)) {
+            return false;
+        }
+        in.skipLine();
+        lineNum++;
+        break;
+    case 'c':
+        ++in;
+        in.parseString(str);
+        if (!parseComments(in, str)) return false;
+        break;
+    case 'x':
+        ++in;
+        if (!parse_and_add_xor_clause(in)) return false;
+        break;
+    case 'b':
+        #ifdef ENABLE_BNN
+        ++in;
+        if (!parse_and_add_bnn_clause(in)) {
+            return false;
+        }
+        #else
+        cerr << "ERROR: BNN encounered but not enabled in parsing. Exiting." << endl;
+        exit(-1);
+        #endif
+        break;
+    case '\n':
+        if (verbosity) {
+            cout
+            << "c WARNING: Empty line at line number " << lineNum+1
+            << " -- this is not part of the DIMACS specifications ("
+            << dimacs_spec << "). Ignoring."
+            << endl;
+        }
+        in.skipLine();
+        lineNum++;
+        break;
+    default:
+        if (!parse_and_add_clause(in)) {
+            return false;
+        }
+        break;
+    }
+
+    return true;
+}
+
+template<class C, class S>
+bool DimacsParser<C, S>::parse_DIMACS_main(C& in)
+{
     for (;;) {
         in.skipWhitespace();
-        switch (*in) {
-        case EOF:
+        if (*in == EOF) {
             if (ind_vars_set) solver->set_sampl_vars(ind_vars);
             return true;
-        case 'p':
-            if (!parse_header(in)) {
-                return false;
-            }
-            in.skipLine();
-            lineNum++;
-            break;
-        case 'c':
-            ++in;
-            in.parseString(str);
-            if (!parseComments(in, str)) return false;
-            break;
-        case 'x':
-            ++in;
-            if (!parse_and_add_xor_clause(in)) return false;
-            break;
-        case 'b':
-            #ifdef ENABLE_BNN
-            ++in;
-            if (!parse_and_add_bnn_clause(in)) {
-                return false;
-            }
-            #else
-            cerr << "ERROR: BNN encounered but not enabled in parsing. Exiting." << endl;
-            exit(-1);
-            #endif
-            break;
-        case '\n':
-            if (verbosity) {
-                cout
-                << "c WARNING: Empty line at line number " << lineNum+1
-                << " -- this is not part of the DIMACS specifications ("
-                << dimacs_spec << "). Ignoring."
-                << endl;
-            }
-            in.skipLine();
-            lineNum++;
-            break;
-        default:
-            if (!parse_and_add_clause(in)) {
-                return false;
-            }
-            break;
+        }
+        if (!parse_line(in)) {
+            return false;
         }
     }
 
     return true;
 }
 
+template<class C, class S>
+void DimacsParser<C, S>::print_stats(const uint32_t origNumVars) const
+{
+    if (verbosity) {
+        cout
+        << "c -- clauses added: " << norm_clauses_added << endl
+        << "c -- xor clauses added: " << xor_clauses_added << endl
+        #ifdef ENABLE_BNN
+        << "c -- bnn clauses added: " << bnn_clauses_added << endl
+        #endif
+        << "c -- vars added " << (solver->nVars() - origNumVars)
+        << endl;
+    }
+}
+
 template <class C, class S>
 template <class T>
 bool DimacsParser<C, S>::parse_DIMACS(
@@ -668,19 +734,270 @@ bool DimacsParser<C, S>::parse_DIMACS(
     const uint32_t origNumVars = solver->nVars();
 
     C in(input_stream);
+    if (*in == bcnf_magic[0]) {
+        vector<char> data;
+        in.read_rest(data);
+        if (is_binary_cnf(data.data(), data.size())) {
+            return parse_binary(data.data(), data.data() + data.size(), origNumVars);
+        }
+        std::cerr
+        << "PARSE ERROR! Unexpected char (hex: 0x7f) At line 1"
+        << please_read_dimacs
+        << endl;
+        return false;
+    }
     if ( !parse_DIMACS_main(in)) {
         return false;
     }
+    print_stats(origNumVars);
+
+    return true;
+}
+
+template<class C, class S>
+bool DimacsParser<C, S>::parse_binary(
+    const char* start, const char* end, const uint32_t origNumVars)
+{
+    BinaryCnfReader<S> reader(solver);
+    if (!reader.parse(start, end-start, offset_vars, strict_header)) {
+        return false;
+    }
+    norm_clauses_added += reader.norm_clauses_added;
+    xor_clauses_added += reader.xor_clauses_added;
+    print_stats(origNumVars);
+    return true;
+}
+
+//Returns false if the line is not a plain clause or comment, or if it
+//is malformed -- the normal parser then deals with it, and reports errors
+template<class C, class S>
+bool DimacsParser<C, S>::tokenize_line(
+    const char* at, const char* eol, MemSegment& seg) const
+{
+    const auto is_ws = [](const char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    };
+    while (at < eol && is_ws(*at)) at++;
+    if (at == eol) {
+        //Empty lines are warned about
+        return !verbosity;
+    }
+
+    if (*at == 'c') {
+        if (verbosity >= 30) return false;
+        at++;
+        while (at < eol && is_ws(*at)) at++;
+        const char* str = at;
+        while (at < eol && *at != ' ') at++;
+        const std::string tok(str, at-str);
+        return !(tok == "red" || tok == "MUST" || tok == "ind" || tok == "p");
+    }
+
+    const size_t orig_size = seg.lits.size();
+    uint32_t num_vars = seg.num_vars;
+    for (;;) {
+        while (at < eol && is_ws(*at)) at++;
+        bool sign = false;
+        if (at < eol && *at == '-') {
+            sign = true;
+            at++;
+        } else if (at < eol && *at == '+') {
+            at++;
+        }
+        if (at == eol || *at < '0' || *at > '9') {
+            seg.lits.resize(orig_size);
+            return false;
+        }
+        uint64_t val = 0;
+        while (at < eol && *at >= '0' && *at <= '9') {
+            val = val*10 + (*at - '0');
+            if (val + offset_vars > (1ULL<<28)) {
+                seg.lits.resize(orig_size);
+                return false;
+            }
+            at++;
+        }
+        if (val == 0) break;
+        if (at == eol || *at != ' ') {
+            seg.lits.resize(orig_size);
+            return false;
+        }
+        const uint32_t var = val - 1 + offset_vars;
+        num_vars = std::max(num_vars, var+1);
+        seg.lits.push_back(Lit(var, sign));
+    }
+    while (at < eol && is_ws(*at)) at++;
+    if (at != eol) {
+        seg.lits.resize(orig_size);
+        return false;
+    }
+
+    seg.lits.push_back(lit_Undef);
+    seg.num_cls++;
+    seg.num_vars = num_vars;
+    return true;
+}
+
+template<class C, class S>
+void DimacsParser<C, S>::tokenize_chunk(
+    const char* start, const char* end, MemChunk& chunk) const
+{
+    chunk.segs.emplace_back();
+    const char* at = start;
+    while (at < end) {
+        const char* eol = (const char*)memchr(at, '\n', end-at);
+        if (eol == nullptr) eol = end;
+        const char* next = (eol == end) ? end : eol+1;
+        if (!tokenize_line(at, eol, chunk.segs.back())) {
+            MemSegment& seg = chunk.segs.back();
+            seg.line_start = at;
+            seg.line_end = next;
+            seg.line_num = chunk.num_lines;
+            chunk.segs.emplace_back();
+        }
+        chunk.num_lines++;
+        at = next;
+    }
+}
+
+template <class C, class S>
+bool DimacsParser<C, S>::parse_DIMACS_mem(
+    const char* start,
+    const char* end,
+    const bool _strict_header,
+    uint32_t _offset_vars,
+    unsigned num_threads)
+{
+    if (is_binary_cnf(start, end-start)) {
+        strict_header = _strict_header;
+        offset_vars = _offset_vars;
+        return parse_binary(start, end, solver->nVars());
+    }
 
+    //The header and the debug library need line-by-line processing
+    if (_strict_header
+        || !debugLib.empty()
+        || max_var != numeric_limits<uint64_t>::max()
+    ) {
+        return parse_DIMACS(MemRange{start, end}, _strict_header, _offset_vars);
+    }
+
+    debugLibPart = 1;
+    strict_header = _strict_header;
+    offset_vars = _offset_vars;
+    const uint32_t origNumVars = solver->nVars();
+    const auto start_time = std::chrono::steady_clock::now();
+
+    //Split into blocks at line boundaries
+    num_threads = std::max(1U, num_threads);
+    vector<const char*> bounds;
+    bounds.push_back(start);
+    const size_t sz = end-start;
+    while (bounds.back() < end) {
+        const char* at = bounds.back() + std::min<size_t>(mem_block_size, end-bounds.back());
+        const char* eol = (at == end) ? nullptr : (const char*)memchr(at, '\n', end-at);
+        bounds.push_back(eol == nullptr ? end : eol+1);
+    }
+    const size_t num_blocks = bounds.size()-1;
+
+    //Block "i" is tokenized into ring[i % ring.size()], which is only free
+    //once block "i - ring.size()" has been added
+    vector<MemChunk> ring(num_threads == 1 ? 1 : 2*num_threads);
+    std::mutex mu;
+    std::condition_variable cv_ready;
+    std::condition_variable cv_free;
+    size_t next_block = 0;
+    size_t consumed = 0;
+    bool stop = false;
+    const auto worker = [&]() {
+        for(;;) {
+            size_t i;
+            {
+                std::unique_lock<std::mutex> lock(mu);
+                cv_free.wait(lock, [&] {
+                    return stop || next_block >= num_blocks
+                        || next_block < consumed + ring.size(); });
+                if (stop || next_block >= num_blocks) return;
+                i = next_block++;
+            }
+            MemChunk& chunk = ring[i % ring.size()];
+            tokenize_chunk(bounds[i], bounds[i+1], chunk);
+            {
+                std::lock_guard<std::mutex> lock(mu);
+                chunk.ready = true;
+            }
+            cv_ready.notify_all();
+        }
+    };
+    vector<std::thread> threads;
+    if (num_threads > 1) {
+        for(unsigned i = 0; i < num_threads; i++) threads.push_back(std::thread(worker));
+    }
+    const auto stop_workers = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            stop = true;
+        }
+        cv_free.notify_all();
+        for(auto& t: threads) t.join();
+    };
+
+    //Add clauses and handle other lines in the order of the file
+    size_t line_base = 0;
+    for(size_t i = 0; i < num_blocks; i++) {
+        MemChunk& chunk = ring[i % ring.size()];
+        if (threads.empty()) {
+            tokenize_chunk(bounds[i], bounds[i+1], chunk);
+        } else {
+            std::unique_lock<std::mutex> lock(mu);
+            cv_ready.wait(lock, [&] { return chunk.ready; });
+        }
+
+        for(MemSegment& seg: chunk.segs) {
+            if (seg.num_cls > 0) {
+                if (seg.num_vars > solver->nVars()) {
+                    solver->new_vars(seg.num_vars - solver->nVars());
+                }
+                solver->add_clauses(seg.lits);
+                norm_clauses_added += seg.num_cls;
+            }
+            vector<Lit>().swap(seg.lits);
+
+            if (seg.line_start != nullptr) {
+                lineNum = line_base + seg.line_num;
+                C in(MemRange{seg.line_start, seg.line_end},
+                     seg.line_end - seg.line_start + 1);
+                in.skipWhitespace();
+                if (*in != EOF && !parse_line(in)) {
+                    stop_workers();
+                    return false;
+                }
+            }
+        }
+        line_base += chunk.num_lines;
+
+        chunk.segs.clear();
+        chunk.num_lines = 0;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            chunk.ready = false;
+            consumed++;
+        }
+        cv_free.notify_all();
+    }
+    stop_workers();
+    lineNum = line_base;
+    if (ind_vars_set) solver->set_sampl_vars(ind_vars);
+
+    print_stats(origNumVars);
     if (verbosity) {
-        cout
-        << "c -- clauses added: " << norm_clauses_added << endl
-        << "c -- xor clauses added: " << xor_clauses_added << endl
-        #ifdef ENABLE_BNN
-        << "c -- bnn clauses added: " << bnn_clauses_added << endl
-        #endif
-        << "c -- vars added " << (solver->nVars() - origNumVars)
-        << endl;
+        const double secs = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start_time).count();
+        cout << "c -- parsed " << std::fixed << std::setprecision(2)
+        << (double)sz/(1024.0*1024.0) << " MB with "
+        << num_threads << " threads at "
+        << (secs > 0 ? (double)sz/(1024.0*1024.0*1024.0)/secs : 0.0) << " GB/s"
+        << std::defaultfloat << endl;
     }
 
     return true;
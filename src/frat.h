@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "clause.h"
 #include "sqlstats.h"
 #include "xor.h"
+#include "proofwriter.h"
 
 
 using std::vector;
@@ -72,6 +73,8 @@ public:
     virtual FILE* getFile() { return nullptr; }
     virtual void flush();
     virtual bool incremental() {return false;}
+    virtual bool set_gzip(int level) { return level <= 0; }
+    virtual void print_stats() const { }
 
     int buf_len;
     unsigned char* drup_buf = nullptr;
@@ -85,10 +88,9 @@ public:
     FratFile(vector<uint32_t>& _inter_to_outerMain) :
         inter_to_outerMain(_inter_to_outerMain)
     {
-        drup_buf = new unsigned char[2 * 1024 * 1024];
+        drup_buf = writer.first_buf();
         buf_ptr = drup_buf;
         buf_len = 0;
-        memset(drup_buf, 0, 2 * 1024 * 1024);
 
         del_buf = new unsigned char[2 * 1024 * 1024];
         del_ptr = del_buf;
@@ -97,14 +99,16 @@ public:
 
     virtual ~FratFile()
     {
-        flush();
-        delete[] drup_buf;
+        frat_flush();
+        writer.finish();
         delete[] del_buf;
     }
 
     virtual void set_sumconflicts_ptr(uint64_t* _sumConflicts) override { sumConflicts = _sumConflicts; }
     virtual void set_sqlstats_ptr(SQLStats* _sqlStats) override { sqlStats = _sqlStats; }
-    virtual void setFile(FILE* _file) override { drup_file = _file; }
+    virtual void setFile(FILE* _file) override { drup_file = _file; writer.set_file(_file); }
+    virtual bool set_gzip(int level) override { return writer.set_gzip(level); }
+    virtual void print_stats() const override { writer.print_stats(); }
     virtual bool something_delayed() override { return delete_filled; }
     virtual bool enabled() override { return true; }
 
@@ -117,9 +121,10 @@ public:
     }
 
     virtual FILE* getFile() override { return drup_file; }
-    virtual void flush() override { frat_flush(); }
+    virtual void flush() override { frat_flush(); writer.sync(); }
+    // Hands the buffer over to the writer thread, continues in an empty one
     void frat_flush() {
-        fwrite(drup_buf, sizeof(unsigned char), buf_len, drup_file);
+        drup_buf = writer.submit(drup_buf, buf_len);
         buf_ptr = drup_buf;
         buf_len = 0;
     }
@@ -426,6 +431,7 @@ private:
     bool adding = false;
     int32_t cl_id = 0;
     FILE* drup_file = nullptr;
+    ProofWriter writer{2 * 1024 * 1024, 4};
     vector<uint32_t>& inter_to_outerMain;
     uint64_t* sumConflicts = nullptr;
     SQLStats* sqlStats = nullptr;
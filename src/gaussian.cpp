@@ -253,6 +253,7 @@ void EGaussian::clear_gwatches(const uint32_t var)
 }
 
 bool EGaussian::full_init(bool& created) {
+    TraceSpan span(solver->trace, "gauss-init");
     assert(solver->okay());
     assert(solver->decisionLevel() == 0);
     assert(solver->prop_at_head());
@@ -1470,6 +1471,15 @@ void CMSat::EGaussian::move_back_xor_clauses() {
     }
 }
 
+size_t CMSat::EGaussian::mem_used() const {
+    size_t mem = mat.mem_used();
+    for(const auto& r: reason_mat) mem += r.capacity();
+    for(const auto& r: xor_reasons) mem += r.reason.capacity()*sizeof(Lit);
+    for(const auto& x: xorclauses) mem += x.size()*sizeof(uint32_t);
+    mem += var_has_resp_row.capacity() + satisfied_xors.capacity();
+    mem += (row_to_var_non_resp.capacity() + col_to_var.capacity())*sizeof(uint32_t);
+    return mem;
+}
 
 void CMSat::EGaussian::delete_reasons() {
     frat_func_start();
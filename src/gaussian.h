@@ -99,6 +99,7 @@ class EGaussian {
     void finalize_frat();
     void delete_reasons();
     void move_back_xor_clauses();
+    size_t mem_used() const;
 
     vector<Xor> xorclauses;
 
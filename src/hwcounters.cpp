@@ -0,0 +1,109 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "hwcounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+using namespace CMSat;
+
+#if defined(__linux__)
+static int perf_open(const uint64_t config, const int group_fd)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = group_fd == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+bool HwCounters::open()
+{
+    const long this_tid = syscall(SYS_gettid);
+    if (enabled() && tid == this_tid) return true;
+    close();
+
+    const uint64_t configs[4] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for(uint32_t i = 0; i < 4; i++) {
+        fds[i] = perf_open(configs[i], i == 0 ? -1 : fds[0]);
+        if (fds[i] < 0) {
+            close();
+            return false;
+        }
+    }
+    leader_fd = fds[0];
+    tid = this_tid;
+    ioctl(leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+void HwCounters::close()
+{
+    for(int& fd: fds) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+    leader_fd = -1;
+    tid = -1;
+}
+
+HwCounts HwCounters::read() const
+{
+    HwCounts c;
+    if (!enabled()) return c;
+
+    // PERF_FORMAT_GROUP: number of events, then the values in opening order
+    uint64_t buf[5];
+    if (::read(leader_fd, buf, sizeof(buf)) != (ssize_t)sizeof(buf) || buf[0] != 4) {
+        return c;
+    }
+    c.cycles = buf[1];
+    c.instructions = buf[2];
+    c.cache_misses = buf[3];
+    c.branch_misses = buf[4];
+    c.valid = true;
+    return c;
+}
+
+#else
+bool HwCounters::open() { return false; }
+void HwCounters::close() {}
+HwCounts HwCounters::read() const { return HwCounts(); }
+#endif
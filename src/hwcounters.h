@@ -0,0 +1,65 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#pragma once
+
+#include <cstdint>
+
+namespace CMSat {
+
+struct HwCounts {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+    uint64_t branch_misses = 0;
+    bool valid = false; ///<False if the counters are off or the read failed
+};
+
+// Hardware performance counters of the calling thread, through Linux
+// perf_event_open(2). Only user-space events are counted, so it works with
+// the default perf_event_paranoid setting. On other systems, or where the
+// kernel or the virtual machine does not expose the PMU, open() fails and
+// everything reads as zero.
+//
+// The four counters form one group, a read() is a single system call.
+class HwCounters {
+public:
+    HwCounters() = default;
+    ~HwCounters() { close(); }
+    HwCounters(const HwCounters&) = delete;
+    HwCounters& operator=(const HwCounters&) = delete;
+
+    // Counters follow the thread that opened them. Reopens if called from
+    // a thread other than the one it was opened on.
+    bool open();
+    void close();
+    bool enabled() const { return leader_fd >= 0; }
+    HwCounts read() const;
+
+private:
+    int leader_fd = -1;
+    int fds[4] = {-1, -1, -1, -1};
+    long tid = -1;
+};
+
+}
@@ -54,10 +54,11 @@ public:
     IdrupFile(vector<uint32_t>& _interToOuterMain) :
         interToOuterMain(_interToOuterMain)
     {
-        drup_buf = new unsigned char[2 * 1024 * 1024];
+        drup_buf = writer.first_buf();
         buf_ptr = drup_buf;
         buf_len = 0;
-        memset(drup_buf, 0, 2 * 1024 * 1024);
+        // IDRUP may be checked interactively, so every buffer is flushed
+        writer.set_flush_every_buf(true);
 
         del_buf = new unsigned char[2 * 1024 * 1024];
         del_ptr = del_buf;
@@ -65,8 +66,8 @@ public:
     }
 
     ~IdrupFile() override {
-        flush();
-        delete[] drup_buf;
+        binDRUP_flush();
+        writer.finish();
         delete[] del_buf;
     }
 
@@ -88,11 +89,12 @@ public:
     void flush() override
     {
       binDRUP_flush();
+      writer.sync();
     }
 
+    // Hands the buffer over to the writer thread, continues in an empty one
     void binDRUP_flush() {
-        fwrite(drup_buf, sizeof(unsigned char), buf_len, drup_file);
-        fflush (drup_file);
+        drup_buf = writer.submit(drup_buf, buf_len);
         buf_ptr = drup_buf;
         buf_len = 0;
     }
@@ -100,6 +102,17 @@ public:
     void setFile(FILE* _file) override
     {
         drup_file = _file;
+        writer.set_file(_file);
+    }
+
+    bool set_gzip(int level) override
+    {
+        return writer.set_gzip(level);
+    }
+
+    void print_stats() const override
+    {
+        writer.print_stats();
     }
 
     bool something_delayed() override
@@ -499,6 +512,7 @@ private:
     int flushing = 0;
     int32_t cl_id = 0;
     FILE* drup_file = nullptr;
+    ProofWriter writer{2 * 1024 * 1024, 4};
     vector<uint32_t>& interToOuterMain;
     uint64_t* sumConflicts = nullptr;
     SQLStats* sqlStats = NULL;
@@ -0,0 +1,297 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <iostream>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef USE_LZMA
+#include <lzma.h>
+#endif
+
+namespace CMSat {
+
+// Decompressor (or plain reader) behind the pipelined input. New formats
+// are added by implementing read() and hooking them into open_input_codec()
+class InputCodec {
+public:
+    virtual ~InputCodec() = default;
+    // Returns the number of bytes put into "buf", 0 at the end, -1 on error
+    virtual long read(char* buf, size_t len) = 0;
+    virtual const char* name() const = 0;
+};
+
+class PlainCodec: public InputCodec {
+public:
+    explicit PlainCodec(FILE* _f, bool _owned) : f(_f), owned(_owned) {}
+    ~PlainCodec() override { if (owned) fclose(f); }
+    long read(char* buf, size_t len) override {
+        const size_t r = fread(buf, 1, len, f);
+        if (r == 0 && ferror(f)) return -1;
+        return r;
+    }
+    const char* name() const override { return "plain"; }
+
+private:
+    FILE* f;
+    bool owned;
+};
+
+#ifdef USE_ZLIB
+class GzCodec: public InputCodec {
+public:
+    explicit GzCodec(gzFile _f) : f(_f) {
+        gzbuffer(f, 1U << 20);
+    }
+    ~GzCodec() override { gzclose(f); }
+    long read(char* buf, size_t len) override {
+        return gzread(f, buf, len);
+    }
+    const char* name() const override { return "gzip"; }
+
+private:
+    gzFile f;
+};
+#endif
+
+#ifdef USE_LZMA
+class XzCodec: public InputCodec {
+public:
+    explicit XzCodec(FILE* _f) : f(_f), in(1U << 20) {}
+    ~XzCodec() override {
+        lzma_end(&strm);
+        fclose(f);
+    }
+    bool init() {
+        return lzma_stream_decoder(&strm, UINT64_MAX, LZMA_CONCATENATED) == LZMA_OK;
+    }
+    long read(char* buf, size_t len) override {
+        strm.next_out = (uint8_t*)buf;
+        strm.avail_out = len;
+        while (strm.avail_out > 0 && !finished) {
+            lzma_action action = LZMA_RUN;
+            if (strm.avail_in == 0) {
+                strm.next_in = in.data();
+                strm.avail_in = fread(in.data(), 1, in.size(), f);
+                if (ferror(f)) return -1;
+                if (feof(f)) action = LZMA_FINISH;
+            } else if (feof(f)) {
+                action = LZMA_FINISH;
+            }
+            const lzma_ret ret = lzma_code(&strm, action);
+            if (ret == LZMA_STREAM_END) finished = true;
+            else if (ret != LZMA_OK) return -1;
+        }
+        return len - strm.avail_out;
+    }
+    const char* name() const override { return "xz"; }
+
+private:
+    FILE* f;
+    std::vector<uint8_t> in;
+    lzma_stream strm = LZMA_STREAM_INIT;
+    bool finished = false;
+};
+#endif
+
+enum class InputFormat {plain, gzip, xz};
+
+inline InputFormat detect_input_format(const unsigned char* magic, const size_t num)
+{
+    const unsigned char xz_magic[6] = {0xfd, '7', 'z', 'X', 'Z', 0x00};
+    if (num >= 6 && memcmp(magic, xz_magic, 6) == 0) return InputFormat::xz;
+    if (num >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) return InputFormat::gzip;
+    return InputFormat::plain;
+}
+
+// Opens "filename" (or standard input if empty), picking the codec from the
+// magic bytes of the file. Returns nullptr on error, with errno set
+inline std::unique_ptr<InputCodec> open_input_codec(const std::string& filename)
+{
+    if (filename.empty()) {
+        #ifdef USE_ZLIB
+        // zlib reads uncompressed data transparently
+        gzFile gz = gzdopen(0, "rb");
+        if (gz == nullptr) return nullptr;
+        return std::unique_ptr<InputCodec>(new GzCodec(gz));
+        #else
+        return std::unique_ptr<InputCodec>(new PlainCodec(stdin, false));
+        #endif
+    }
+
+    FILE* f = fopen(filename.c_str(), "rb");
+    if (f == nullptr) return nullptr;
+    unsigned char magic[6] = {0, 0, 0, 0, 0, 0};
+    const size_t num = fread(magic, 1, sizeof(magic), f);
+    rewind(f);
+
+    const InputFormat format = detect_input_format(magic, num);
+
+    #ifdef USE_LZMA
+    if (format == InputFormat::xz) {
+        XzCodec* xz = new XzCodec(f);
+        std::unique_ptr<InputCodec> ret(xz);
+        if (!xz->init()) return nullptr;
+        return ret;
+    }
+    #endif
+
+    #ifdef USE_ZLIB
+    if (format == InputFormat::gzip) {
+        fclose(f);
+        gzFile gz = gzopen(filename.c_str(), "rb");
+        if (gz == nullptr) return nullptr;
+        return std::unique_ptr<InputCodec>(new GzCodec(gz));
+    }
+    #endif
+    (void)format;
+
+    return std::unique_ptr<InputCodec>(new PlainCodec(f, true));
+}
+
+// Runs the codec on a separate thread, filling a ring of buffers while the
+// parser consumes the previous ones
+class PipelinedInput {
+public:
+    explicit PipelinedInput(
+        std::unique_ptr<InputCodec> _codec,
+        size_t _buf_size = 1U << 20,
+        unsigned num_bufs = 4
+    ) :
+        codec(std::move(_codec))
+        , bufs(num_bufs)
+    {
+        for(auto& b: bufs) b.data.resize(_buf_size);
+        producer = std::thread(&PipelinedInput::produce, this);
+    }
+
+    ~PipelinedInput() {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            stop = true;
+        }
+        cv.notify_all();
+        producer.join();
+    }
+
+    PipelinedInput(const PipelinedInput&) = delete;
+    PipelinedInput& operator=(const PipelinedInput&) = delete;
+
+    // Copies at most "len" bytes into "out". Returns 0 at the end of input
+    int read(char* out, size_t len) {
+        size_t done = 0;
+        while (done < len) {
+            Buf& b = bufs[consume_at];
+            if (consume_pos == 0) {
+                std::unique_lock<std::mutex> lock(mu);
+                cv.wait(lock, [&]{ return b.full; });
+            }
+            if (b.size == 0) break; // end of input or error
+            const size_t n = std::min(len - done, b.size - consume_pos);
+            memcpy(out + done, b.data.data() + consume_pos, n);
+            done += n;
+            consume_pos += n;
+            if (consume_pos == b.size) {
+                {
+                    std::lock_guard<std::mutex> lock(mu);
+                    b.full = false;
+                }
+                cv.notify_all();
+                consume_pos = 0;
+                consume_at = (consume_at + 1) % bufs.size();
+                break;
+            }
+        }
+        return done;
+    }
+
+    bool error() const { return failed; }
+    const char* codec_name() const { return codec->name(); }
+
+private:
+    struct Buf {
+        std::vector<char> data;
+        size_t size = 0;
+        bool full = false;
+    };
+
+    void produce() {
+        size_t at = 0;
+        for(;;) {
+            Buf& b = bufs[at];
+            {
+                std::unique_lock<std::mutex> lock(mu);
+                cv.wait(lock, [&]{ return !b.full || stop; });
+                if (stop) return;
+            }
+
+            long r = codec->read(b.data.data(), b.data.size());
+            if (r < 0) {
+                failed = true;
+                r = 0;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mu);
+                b.size = r;
+                b.full = true;
+            }
+            cv.notify_all();
+            if (r == 0) return;
+            at = (at + 1) % bufs.size();
+        }
+    }
+
+    std::unique_ptr<InputCodec> codec;
+    std::vector<Buf> bufs;
+    std::thread producer;
+    std::mutex mu;
+    std::condition_variable cv;
+    bool stop = false;
+    bool failed = false;
+
+    // Only touched by the consumer
+    size_t consume_at = 0;
+    size_t consume_pos = 0;
+};
+
+// StreamBuffer adaptor for PipelinedInput
+struct PIPE {
+    static inline int read(void* buf, size_t num, size_t count, PipelinedInput* f)
+    {
+        return f->read((char*)buf, num*count);
+    }
+};
+
+}
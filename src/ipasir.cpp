@@ -51,6 +51,11 @@ struct MySolver {
     vector<Lit> assumptions;
     vector<Lit> last_conflict;
     vector<char> conflict_cl_map;
+
+    //ipasir_set_learn
+    void* learn_state = nullptr;
+    void (*learn)(void * state, int * clause) = nullptr;
+    vector<int> learnt_cl;
 };
 
 extern "C" {
@@ -107,6 +112,22 @@ void ensure_var_created(MySolver& s, Lit lit)
         s.solver->new_vars(toadd);
     }
 }
+
+void learn_batch(void* state, const vector<Lit>& cls)
+{
+    MySolver* s = (MySolver*)state;
+    s->learnt_cl.clear();
+    for(const Lit l: cls) {
+        if (l == lit_Undef) {
+            s->learnt_cl.push_back(0);
+            s->learn(s->learn_state, s->learnt_cl.data());
+            s->learnt_cl.clear();
+        } else {
+            const int v = (int)l.var()+1;
+            s->learnt_cl.push_back(l.sign() ? -v : v);
+        }
+    }
+}
 }
 
 /**
@@ -260,9 +281,26 @@ DLL_PUBLIC void ipasir_set_terminate (void * /*solver*/, void * /*state*/, int (
     //this is complicated.
 }
 
-DLL_PUBLIC void ipasir_set_learn (void * /*solver*/, void * /*state*/, int /*max_length*/, void (* /*learn*/)(void * state, int * clause))
+/**
+ * Set a callback function used to extract learned clauses up to a given length from the
+ * solver. The solver calls this function for each learned clause of at most
+ * "max_length" literals, with "state" and a zero-terminated array of literals.
+ * Clauses are handed over in batches, at the latest at every restart.
+ * Passing NULL as "learn" disables the callback.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT or SAT or UNSAT
+ */
+DLL_PUBLIC void ipasir_set_learn (void * solver, void * state, int max_length, void (*learn)(void * state, int * clause))
 {
-    //this is complicated
+    MySolver* s = (MySolver*)solver;
+    s->learn_state = state;
+    s->learn = learn;
+    if (learn == nullptr || max_length < 0) {
+        s->solver->set_learnt_clause_callback(nullptr, nullptr, 0);
+    } else {
+        s->solver->set_learnt_clause_callback(s, learn_batch, (uint32_t)max_length);
+    }
 }
 
 DLL_PUBLIC int ipasir_simplify (void * solver)
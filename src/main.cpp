@@ -33,13 +33,22 @@ THE SOFTWARE.
 #include <sys/stat.h>
 #include <cstring>
 #include <thread>
+#include <set>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include "main.h"
 #include "time_mem.h"
 #include "dimacsparser.h"
+#include "inputcodec.h"
 #include "cryptominisat.h"
 #include "signalcode.h"
 #include "argparse.hpp"
+#include "binarycnf.h"
+#include "serializer.h"
 
 using namespace CMSat;
 
@@ -63,19 +72,59 @@ Main::Main(int _argc, char** _argv) :
 {
 }
 
+//Uncompressed regular files are mapped into memory and parsed in parallel.
+//Returns false if the file must be read the normal way
+bool Main::read_in_a_file_mmap(SATSolver* solver2, const string& filename)
+{
+    #ifdef _WIN32
+    (void)solver2;
+    (void)filename;
+    return false;
+    #else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < 2) {
+        close(fd);
+        return false;
+    }
+    const size_t sz = st.st_size;
+    void* map = mmap(nullptr, sz, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    const char* data = (const char*)map;
+    if (detect_input_format((const unsigned char*)data, sz) != InputFormat::plain) {
+        munmap(map, sz);
+        return false;
+    }
+    madvise(map, sz, MADV_SEQUENTIAL);
+
+    //Small files are not worth the threads
+    unsigned threads = parse_threads;
+    if (threads == 0) threads = std::max(1U, std::thread::hardware_concurrency());
+    threads = std::min<size_t>(threads, sz/(4ULL*1024ULL*1024ULL) + 1);
+
+    DimacsParser<StreamBuffer<MemRange, MEM>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
+    const bool ok = parser.parse_DIMACS_mem(data, data+sz, false, 0, threads);
+    munmap(map, sz);
+    if (!ok) exit(-1);
+    return true;
+    #endif
+}
+
 void Main::readInAFile(SATSolver* solver2, const string& filename)
 {
     solver2->add_sql_tag("filename", filename);
     if (conf.verbosity) cout << "c Reading file '" << filename << "'" << endl;
-    #ifndef USE_ZLIB
-    FILE * in = fopen(filename.c_str(), "rb");
-    DimacsParser<StreamBuffer<FILE*, FN>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
-    #else
-    gzFile in = gzopen(filename.c_str(), "rb");
-    DimacsParser<StreamBuffer<gzFile, GZ>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
-    #endif
+    if (parse_threads != 1 && debugLib.empty()
+        && read_in_a_file_mmap(solver2, filename)
+    ) {
+        return;
+    }
 
-    if (in == nullptr) {
+    std::unique_ptr<InputCodec> codec = open_input_codec(filename);
+    if (codec == nullptr) {
         std::cerr
         << "ERROR! Could not open file '"
         << filename
@@ -83,47 +132,41 @@ void Main::readInAFile(SATSolver* solver2, const string& filename)
 
         std::exit(1);
     }
+    if (conf.verbosity >= 2) {
+        cout << "c Reading file as '" << codec->name() << "'" << endl;
+    }
 
+    PipelinedInput in(std::move(codec));
+    DimacsParser<StreamBuffer<PipelinedInput*, PIPE>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
     bool strict_header = false;
-    if (!parser.parse_DIMACS(in, strict_header)) {
+    if (!parser.parse_DIMACS(&in, strict_header)) {
+        exit(-1);
+    }
+    if (in.error()) {
+        std::cerr << "ERROR! Could not decompress file '" << filename << "'" << endl;
         exit(-1);
     }
-
-    #ifndef USE_ZLIB
-        fclose(in);
-    #else
-        gzclose(in);
-    #endif
 }
 
 void Main::readInStandardInput(SATSolver* solver2)
 {
     if (conf.verbosity) cout << "c Reading from standard input... Use '-h' or '--help' for help." << endl;
 
-    #ifndef USE_ZLIB
-    FILE * in = stdin;
-    #else
-    gzFile in = gzdopen(0, "rb"); //opens stdin, which is 0
-    #endif
-
-    if (in == nullptr) {
+    std::unique_ptr<InputCodec> codec = open_input_codec(string());
+    if (codec == nullptr) {
         std::cerr << "ERROR! Could not open standard input for reading" << endl;
         std::exit(1);
     }
 
-    #ifndef USE_ZLIB
-    DimacsParser<StreamBuffer<FILE*, FN>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
-    #else
-    DimacsParser<StreamBuffer<gzFile, GZ>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
-    #endif
-
-    if (!parser.parse_DIMACS(in, false)) {
+    PipelinedInput in(std::move(codec));
+    DimacsParser<StreamBuffer<PipelinedInput*, PIPE>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
+    if (!parser.parse_DIMACS(&in, false)) {
+        exit(-1);
+    }
+    if (in.error()) {
+        std::cerr << "ERROR! Could not decompress standard input" << endl;
         exit(-1);
     }
-
-    #ifdef USE_ZLIB
-        gzclose(in);
-    #endif
 }
 
 void Main::parseInAllFiles(SATSolver* solver2)
@@ -181,23 +224,11 @@ void Main::printResultFunc(
 
     if (ret == l_True && (printResult || toFile)) {
         if (toFile) {
-            auto fun = [&](uint32_t var) {
-                if (solver->get_model()[var] != l_Undef) {
-                    *os << ((solver->get_model()[var] == l_True)? "" : "-") << var+1 << " ";
-                }
-            };
-
             if (!solver->get_sampl_vars_set()) {
-                for (uint32_t var = 0; var < solver->nVars(); var++) {
-                    fun(var);
-                }
-
+                print_model(solver, os, nullptr, false);
             } else {
-                for (uint32_t var: solver->get_sampl_vars()) {
-                    fun(var);
-                }
+                print_model(solver, os, &solver->get_sampl_vars(), false);
             }
-            *os << "0" << endl;
         } else {
             uint32_t num_undef;
             if (!solver->get_sampl_vars_set()) {
@@ -236,6 +267,14 @@ void Main::add_supported_options() {
         .default_value(1)
         .action([&](const auto& a) {num_threads = std::atoi(a.c_str());})
         .help("Number of threads");
+    program.add_argument("--oraclethreads")
+        .action([&](const auto& a) {conf.oracle_threads = std::atoi(a.c_str());})
+        .default_value(conf.oracle_threads)
+        .help("Number of threads for oracle-based vivification. The clauses are split between them, each with its own oracle, and learnt units are shared");
+    program.add_argument("--nativebackbone")
+        .action([&](const auto& a) {conf.backbone_native = std::atoi(a.c_str());})
+        .default_value(conf.backbone_native)
+        .help("Compute the backbone with our own search, keeping learnt clauses and phases, instead of handing a copy of the CNF to CadiBack");
     program.add_argument("-m", "--mult")
         .action([&](const auto& a) {conf.orig_global_timeout_multiplier = std::atof(a.c_str());})
         .default_value(conf.orig_global_timeout_multiplier)
@@ -248,6 +287,10 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.var_and_mem_out_mult = std::atof(a.c_str());})
         .default_value(conf.var_and_mem_out_mult)
         .help("Multiplier for memory-out checks on inprocessing functions. It limits things such as clause-link-in. Useful when you have limited memory but still want to do some inprocessing");
+    program.add_argument("--membudget")
+        .action([&](const auto& a) {conf.mem_budget_bytes = std::atoll(a.c_str())*1024ULL*1024ULL;})
+        .default_value(conf.mem_budget_bytes/(1024ULL*1024ULL))
+        .help("Memory budget for the whole process in MB, 0 = unlimited. Close to it, the learnt clause database is cut and memory-hungry inprocessing is skipped. If still over it, the solver stops with INDETERMINATE");
     program.add_argument("--maxsol")
         .action([&](const auto& a) {max_nr_of_solutions = std::atoll(a.c_str());})
         .default_value(max_nr_of_solutions)
@@ -441,6 +484,10 @@ void Main::add_supported_options() {
     program.add_argument("--debuglib")
         .action([&](const auto& a) {debugLib = a;})
         .help("Parse special comments to run solve/simplify during parsing of CNF");
+    program.add_argument("--parsethreads")
+        .action([&](const auto& a) {parse_threads = std::atoi(a.c_str());})
+        .default_value(parse_threads)
+        .help("Number of threads to parse uncompressed CNF files with. 0 = automatic, 1 = read the file as a stream");
 
     /* po::options_description breakid_options("Breakid options"); */
     program.add_argument("--breakid")
@@ -568,10 +615,28 @@ void Main::add_supported_options() {
     program.add_argument("--preschedule")
         .action([&](const auto& a) {conf.simplify_schedule_startup = a;})
         .help("Schedule for simplification at startup");
+    program.add_argument("--preproccache")
+        .action([&](const auto& a) {preproc_cache_dir = a;})
+        .help("Directory to cache the result of simplification at startup in, keyed by the input file and the configuration. Only used when looking for a single solution, without assumptions, proofs or BVA");
+    program.add_argument("--checkpoint")
+        .action([&](const auto& a) {checkpoint_fname = a;})
+        .help("Periodically save the state of the search to this file, and resume from it if it exists. The input files are not read when resuming. Not possible with proofs");
+    program.add_argument("--checkpointevery")
+        .action([&](const auto& a) {checkpoint_every_secs = std::atof(a.c_str());})
+        .default_value(checkpoint_every_secs)
+        .help("Save a checkpoint every this many wallclock seconds");
     program.add_argument("--occsimp")
         .action([&](const auto& a) {conf.perform_occur_based_simp = std::atoi(a.c_str());})
         .default_value(conf.perform_occur_based_simp)
         .help("Perform occurrence-list-based optimisations (variable elimination, subsumption, bounded variable addition...)");
+    program.add_argument("--occincr")
+        .action([&](const auto& a) {conf.occ_incremental = std::atoi(a.c_str());})
+        .default_value(conf.occ_incremental)
+        .help("Repeated occ runs with the same schedule only run BVE on variables whose irredundant clauses or eligibility changed since the last run. BVE-only runs are skipped if none did");
+    program.add_argument("--incrinproc")
+        .action([&](const auto& a) {conf.inprocess_incremental = std::atoi(a.c_str());})
+        .default_value(conf.inprocess_incremental)
+        .help("Binary subsumption and strengthening, binary cleaning and SCC only look at the watchlists where binaries were added or variables were set since their last run");
     program.add_argument("--confbtwsimp")
         .action([&](const auto& a) {conf.num_conflicts_of_search = std::atoll(a.c_str());})
         .default_value(conf.num_conflicts_of_search)
@@ -880,6 +945,10 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.must_always_conslidate = std::atoi(a.c_str());})
         .default_value(conf.must_always_conslidate)
         .help("Always consolidate, even if not useful. This is used for debugging ONLY");
+    program.add_argument("--consolidatetier")
+        .action([&](const auto& a) {conf.consolidate_by_tier = std::atoi(a.c_str());})
+        .default_value(conf.consolidate_by_tier)
+        .help("When consolidating the clause arena, pack irredundant and tier-0 clauses together first, then tier-1 ones, in the order the watchlists of the hottest literals visit them");
     program.add_argument("--savemem")
         .action([&](const auto& a) {conf.doSaveMem = std::atoi(a.c_str());})
         .default_value(conf.doSaveMem)
@@ -888,6 +957,10 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.must_renumber = std::atoi(a.c_str());})
         .default_value(conf.must_renumber)
         .help("Treat all 'renumber' strategies as 'must-renumber'");
+    program.add_argument("--renumorder")
+        .action([&](const auto& a) {conf.renumber_order = std::atoi(a.c_str());})
+        .default_value(conf.renumber_order)
+        .help("Order of variables when renumbering. 0 = compact only, 1 = BFS over the clause graph, 2 = Louvain communities, each in BFS order (needs a STATS build, otherwise same as 1). With 1 or 2, the first renumbering happens even if it saves little");
     program.add_argument("--fullwatchconseveryn")
         .action([&](const auto& a) {conf.full_watch_consolidate_every_n_confl = std::atoll(a.c_str());})
         .default_value(conf.full_watch_consolidate_every_n_confl)
@@ -990,6 +1063,19 @@ void Main::add_supported_options() {
     program.add_argument("--dumpresult")
         .action([&](const auto& a) {result_fname = a;})
         .help("Write solution(s) to this file");
+    program.add_argument("--telemetry")
+        .action([&](const auto& a) {telemetry_fname = a;})
+        .help("Write per-phase timing and effectiveness data as JSON to this file at the end");
+    program.add_argument("--hwcounters")
+        .action([&](const auto& a) {conf.hw_counters = std::atoi(a.c_str());})
+        .default_value(conf.hw_counters)
+        .help("Attribute hardware performance counters (IPC, cache and branch misses) to solver phases. Shown in the stats and the telemetry output. Linux only");
+    program.add_argument("--trace")
+        .action([&](const auto& a) {trace_fname = a;})
+        .help("Write a timeline of solver activity to this file, in the Chrome trace event format (chrome://tracing, ui.perfetto.dev)");
+    program.add_argument("--binmodel")
+        .action([&](const auto& a) {binmodel_fname = a;})
+        .help("Write the model in binary to this file: the magic 'CMSMODL1', the number of variables as a 64-bit integer, then one byte per variable: 1 = true, 0 = false, 2 = unset");
 
     //these a kind of special and determine positional options' meanings
     program.add_argument("files").remaining().help("input file and FRAT output");
@@ -1234,6 +1320,10 @@ int Main::solve()
     check_num_threads_sanity(num_threads);
     solver->set_num_threads(num_threads);
     if (sql != 0) solver->set_sqlite(sqlite_filename);
+    if (!trace_fname.empty() && !solver->set_trace_file(trace_fname)) {
+        std::cerr << "ERROR: could not open trace file '" << trace_fname << "'" << endl;
+        std::exit(-1);
+    }
 
     //Print command line used to execute the solver: for options and inputs
     if (conf.verbosity) {
@@ -1256,9 +1346,23 @@ int Main::solve()
     solver->add_sql_tag("compiler", "non-gcc");
     #endif
 
+    bool resumed = false;
+    if (!checkpoint_fname.empty()) {
+        if (fratf || idrupf) {
+            cout << "c WARNING: checkpointing is not possible with proofs, ignoring --checkpoint" << endl;
+            checkpoint_fname.clear();
+        } else {
+            resumed = solver->load_state(checkpoint_fname);
+            if (resumed && conf.verbosity) {
+                cout << "c Resuming from checkpoint '" << checkpoint_fname << "'" << endl;
+            }
+            solver->set_checkpoint(checkpoint_fname, checkpoint_every_secs);
+        }
+    }
+
     //Parse in DIMACS (maybe gzipped) files
     //solver->log_to_file("mydump.cnf");
-    parseInAllFiles(solver);
+    if (!resumed) parseInAllFiles(solver);
     if (!assump_filename.empty()) {
         std::ifstream* tmp = new std::ifstream;
         tmp->open(assump_filename.c_str());
@@ -1274,12 +1378,25 @@ int Main::solve()
         delete tmp;
     }
 
-    lbool ret = multi_solutions();
+    lbool ret;
+    if (!preproc_cache_dir.empty() && checkpoint_fname.empty() && preproc_cache_usable()) {
+        ret = solve_with_preproc_cache();
+    } else {
+        if (single_run_possible()) solver->set_single_run();
+        ret = multi_solutions();
+    }
     if (ret == l_Undef && conf.verbosity) {
         cout
         << "c Not finished running -- signal caught or some maximum reached"
         << endl;
     }
+    if (ret == l_Undef && !checkpoint_fname.empty()) {
+        if (!solver->save_state(checkpoint_fname)) {
+            cout << "c WARNING: could not save checkpoint to '" << checkpoint_fname << "'" << endl;
+        } else if (conf.verbosity) {
+            cout << "c Saved checkpoint to '" << checkpoint_fname << "'" << endl;
+        }
+    }
     if (conf.verbosity) {
         solver->print_stats(wallclock_time_started);
     }
@@ -1288,6 +1405,16 @@ int Main::solve()
     if (resultfile) {
         printResultFunc(resultfile, true, ret);
     }
+    if (!telemetry_fname.empty()) {
+        std::ofstream f(telemetry_fname.c_str());
+        f << solver->get_phase_stats_json();
+        if (!f) std::cerr << "ERROR: could not write telemetry to '" << telemetry_fname << "'" << endl;
+    }
+    if (ret == l_True && !binmodel_fname.empty()
+        && !write_binary_model(solver, binmodel_fname)
+    ) {
+        std::cerr << "ERROR: could not write binary model to '" << binmodel_fname << "'" << endl;
+    }
     if (ret == l_True && max_nr_of_solutions > 1) {
        // If ret is l_True then we must have hit the solution limit.
        // Print final number of solutions when we hit the limit here
@@ -1302,60 +1429,369 @@ int Main::solve()
        }
     }
 
+    if ((fratf || idrupf) && !close_proof()) {
+        std::cerr << "ERROR: the proof is incomplete" << endl;
+        return -1;
+    }
     return correctReturnValue(ret);
 }
 
+// The proof is only complete once the solver is gone. Returns false if
+// any part of it could not be written
+bool Main::close_proof()
+{
+    delete solver;
+    solver = nullptr;
+    bool ok = true;
+    for(FILE** f: {&fratf, &idrupf}) {
+        if (*f == nullptr) continue;
+        const bool write_error = ferror(*f);
+        if (fclose(*f) != 0 || write_error) ok = false;
+        *f = nullptr;
+    }
+    return ok;
+}
+
 lbool Main::multi_solutions()
 {
-    if (max_nr_of_solutions == 1
-        && fratf == nullptr
-        && debugLib.empty()
-    ) {
-        solver->set_single_run();
+    nr_of_solutions = 0;
+    if (!dont_ban_solutions) {
+        const vector<uint32_t>* projection = nullptr;
+        if (solver->get_sampl_vars_set()) projection = &solver->get_sampl_vars();
+        return solver->enumerate(this, found_solution, max_nr_of_solutions, projection, &assumps);
     }
 
-    unsigned long current_nr_of_solutions = 0;
     lbool ret = l_True;
-    while(current_nr_of_solutions < max_nr_of_solutions && ret == l_True) {
+    while(nr_of_solutions < max_nr_of_solutions && ret == l_True) {
         ret = solver->solve(&assumps);
-        current_nr_of_solutions++;
+        if (ret == l_True) found_solution(this, solver->get_model());
+    }
+    return ret;
+}
 
-        if (ret == l_True && current_nr_of_solutions < max_nr_of_solutions) {
-            printResultFunc(&cout, false, ret);
-            if (resultfile) {
-                printResultFunc(resultfile, true, ret);
-            }
+//The last solution is printed by the caller
+bool Main::found_solution(void* state, const vector<lbool>&)
+{
+    Main* m = (Main*)state;
+    m->nr_of_solutions++;
+    if (m->nr_of_solutions >= m->max_nr_of_solutions) return false;
 
-            if (conf.verbosity) {
-                cout
-                << "c Number of solutions found until now: "
-                << std::setw(6) << current_nr_of_solutions
-                << endl;
-            }
+    m->printResultFunc(&cout, false, l_True);
+    if (m->resultfile) {
+        m->printResultFunc(m->resultfile, true, l_True);
+    }
+
+    if (m->conf.verbosity) {
+        cout
+        << "c Number of solutions found until now: "
+        << std::setw(6) << m->nr_of_solutions
+        << endl;
+    }
+    return true;
+}
+
+///////////
+// Preprocessing cache
+///////////
+
+bool Main::preproc_cache_usable() const
+{
+    string reason;
+    if (!fileNamePresent) reason = "reading from standard input";
+    else if (max_nr_of_solutions != 1) reason = "more than one solution requested";
+    else if (fratf || idrupf) reason = "proof output requested";
+    else if (!assumps.empty()) reason = "assumptions given";
+    else if (!debugLib.empty()) reason = "debuglib given";
+    else if (conf.do_bva) reason = "BVA is on";
+    else if (!conf.doRenumberVars || !conf.doSaveMem) reason = "renumbering is off";
+    else if (!conf.do_simplify_problem) reason = "simplification is off";
+
+    if (!reason.empty() && conf.verbosity) {
+        cout << "c Preprocessing cache not used: " << reason << endl;
+    }
+    return reason.empty();
+}
 
-            if (!dont_ban_solutions) ban_found_solution();
+// The whole configuration: the build fixes the defaults, and every option
+// given on the command line is included, except for the few that can't
+// change the result of simplification at startup. The fields below are also
+// included as Main may change them after parsing the options
+string Main::preproc_cache_conf_key() const
+{
+    static const std::set<string> ignored = {
+        "--verb", "--maxtime", "--maxconfl", "--preproccache", "--printsol", "-s"};
+    std::stringstream ss;
+    ss << solver->get_version_sha1() << " args:";
+    for(int i = 1; i < argc; i++) {
+        const string arg = argv[i];
+        const string name = arg.substr(0, arg.find('='));
+        if (ignored.count(name)) {
+            if (name == arg && i+1 < argc) i++;
+            continue;
         }
+        if (arg == input_file) continue;
+        ss << arg << " ";
     }
-    return ret;
+    ss << " sched:" << conf.simplify_schedule_startup
+    << " seed:" << conf.origSeed
+    << " occ:" << conf.perform_occur_based_simp
+    << " xor:" << conf.doFindXors << "," << conf.maxXorToFind << "," << conf.allow_elim_xor_vars
+    << " scc:" << conf.doFindAndReplaceEqLits
+    << " subimpl:" << conf.doStrSubImplicit
+    << " str:" << conf.do_strengthen_with_occur
+    << " card:" << conf.doFindCard
+    << " breakid:" << conf.doBreakid
+    << " tmult:" << conf.orig_global_timeout_multiplier
+    << " threads:" << num_threads;
+    if (solver->get_sampl_vars_set()) {
+        ss << " sampl:";
+        for(const uint32_t v: solver->get_sampl_vars()) ss << v << ",";
+    }
+    return ss.str();
+}
+
+bool Main::single_run_possible() const
+{
+    return max_nr_of_solutions == 1
+        && fratf == nullptr
+        && debugLib.empty();
 }
 
-void Main::ban_found_solution() {
-    vector<Lit> lits;
-    if (!solver->get_sampl_vars_set()) {
-        //all of the solution
-        for (uint32_t var = 0; var < solver->nVars(); var++) {
-            if (solver->get_model()[var] != l_Undef) {
-                lits.push_back( Lit(var, (solver->get_model()[var] == l_True)? true : false) );
+// FNV-1a on 8-byte words. Unlike std::hash, it's the same for every build,
+// so cache entries can be shared
+static uint64_t fnv_hash(uint64_t hash, const char* data, const size_t num)
+{
+    size_t i = 0;
+    for(; i + 8 <= num; i += 8) {
+        uint64_t w;
+        memcpy(&w, data + i, 8);
+        hash = (hash ^ w) * 0x100000001b3ULL;
+    }
+    for(; i < num; i++) hash = (hash ^ (uint8_t)data[i]) * 0x100000001b3ULL;
+    return hash;
+}
+
+static bool hash_file(const string& fname, uint64_t& hash, uint64_t& size)
+{
+    FILE* f = fopen(fname.c_str(), "rb");
+    if (f == nullptr) return false;
+
+    hash = 0xcbf29ce484222325ULL;
+    size = 0;
+    vector<char> buf(1U << 20);
+    size_t num;
+    while((num = fread(buf.data(), 1, buf.size(), f)) > 0) {
+        size += num;
+        hash = fnv_hash(hash, buf.data(), num);
+    }
+    const bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+lbool Main::solve_with_preproc_cache()
+{
+    uint64_t hash;
+    uint64_t size;
+    if (!hash_file(input_file, hash, size)) {
+        cout << "c WARNING: could not read '" << input_file << "' for hashing,"
+        << " not using the preprocessing cache" << endl;
+        if (single_run_possible()) solver->set_single_run();
+        return multi_solutions();
+    }
+
+    std::stringstream input_key;
+    input_key << " input:" << std::hex << hash << ":" << size;
+    const string key = preproc_cache_conf_key() + input_key.str();
+    std::stringstream name;
+    name << std::hex << std::setfill('0')
+    << std::setw(16) << hash
+    << std::setw(16) << fnv_hash(0xcbf29ce484222325ULL, key.data(), key.size())
+    << std::setw(8) << size;
+    const string base = preproc_cache_dir + "/cms-preproc-" + name.str();
+
+    lbool ret;
+    if (solve_from_preproc_cache(base, key, ret)) return ret;
+
+    //Simplified first, then solved: not a single run
+    fill_preproc_cache(base, key);
+    return multi_solutions();
+}
+
+static const string preproc_cache_magic = "cms-preproc-2";
+
+// Solves the cached simplified CNF, then extends its model to the original
+// variables and checks it on the original CNF. An UNSAT result can't be
+// checked that way, so an entry is only used if it was made for the same
+// input file and configuration, and its simplified CNF is unchanged.
+// Returns false on a miss
+bool Main::solve_from_preproc_cache(const string& base, const string& key, lbool& ret)
+{
+    const double my_time = cpuTime();
+    std::ifstream rec_file(base + ".rec", std::ios::binary);
+    if (!rec_file) {
+        if (conf.verbosity) cout << "c Preprocessing cache miss" << endl;
+        return false;
+    }
+    std::stringstream rec_data;
+    rec_data << rec_file.rdbuf();
+    const string data = rec_data.str();
+
+    InArchive ar(data);
+    string magic;
+    string key2;
+    string recon;
+    uint32_t simp_nvars = 0;
+    uint64_t cnf_hash = 0;
+    uint64_t cnf_size = 0;
+    ar >> magic >> key2 >> cnf_hash >> cnf_size >> simp_nvars >> recon;
+    uint64_t cnf_hash2;
+    uint64_t cnf_size2;
+    if (ar.failed() || !ar.at_end()
+        || magic != preproc_cache_magic
+        || key2 != key
+        || !hash_file(base + ".bcnf", cnf_hash2, cnf_size2)
+        || cnf_hash2 != cnf_hash
+        || cnf_size2 != cnf_size
+    ) {
+        cout << "c WARNING: preprocessing cache entry '" << base << "' is invalid, ignoring it" << endl;
+        return false;
+    }
+    void* setup = SATSolver::create_extend_solution_setup(recon);
+    if (setup == nullptr) {
+        cout << "c WARNING: preprocessing cache entry '" << base << "' is invalid, ignoring it" << endl;
+        return false;
+    }
+    if (conf.verbosity) cout << "c Preprocessing cache hit: '" << base << "'" << endl;
+
+    lbool simp_ret;
+    vector<lbool> model;
+    {
+        SATSolver simp((void*)&conf);
+        simp.set_num_threads(num_threads);
+        if (program.is_used("maxtime")) simp.set_max_time(program.get<double>("maxtime"));
+        if (program.is_used("maxconfl")) simp.set_max_confl(program.get<uint64_t>("maxconfl"));
+        simp.set_no_simplify_at_startup();
+        if (single_run_possible()) simp.set_single_run();
+        readInAFile(&simp, base + ".bcnf");
+        if (simp.nVars() > simp_nvars) {
+            cout << "c WARNING: preprocessing cache entry '" << base << "' is invalid, ignoring it" << endl;
+            SATSolver::delete_extend_solution_setup(setup);
+            return false;
+        }
+        if (conf.verbosity) {
+            cout << "c Simplified CNF from cache has " << simp_nvars << " variables, read in "
+            << std::fixed << std::setprecision(2) << (cpuTime() - my_time) << " s" << endl;
+        }
+
+        solverToInterrupt = &simp;
+        simp_ret = simp.solve();
+        solverToInterrupt = solver;
+        if (simp_ret == l_True) model = simp.get_model();
+    }
+
+    ret = simp_ret;
+    if (simp_ret == l_False) {
+        solver->add_clause(vector<Lit>());
+    } else if (simp_ret == l_True) {
+        model.resize(simp_nvars, l_False);
+        for(auto& v: model) if (v == l_Undef) v = l_False;
+        const auto ext = SATSolver::extend_solution(setup, model);
+
+        // Let the original solver check the model and take it over
+        vector<Lit> full;
+        for(uint32_t i = 0; i < ext.second.size() && i < solver->nVars(); i++) {
+            if (ext.second[i] == l_Undef) continue;
+            full.push_back(Lit(i, ext.second[i] == l_False));
+        }
+        solver->set_no_simplify_at_startup();
+        ret = solver->solve(&full);
+        if (ret != l_True) {
+            cout << "c WARNING: model from the preprocessing cache does not satisfy the CNF,"
+            << " solving from scratch" << endl;
+            ret = solver->solve();
+        }
+    }
+    SATSolver::delete_extend_solution_setup(setup);
+    return true;
+}
+
+// Runs simplification at startup on the original solver, then stores the
+// simplified CNF and what's needed to reconstruct models of the original.
+// The ".rec" file is written last, so an entry without it is never used
+void Main::fill_preproc_cache(const string& base, const string& key)
+{
+    const double my_time = cpuTime();
+    const string sched = conf.simplify_schedule_startup + ", must-renumber";
+    solver->simplify(nullptr, &sched);
+
+    const uint32_t simp_nvars = solver->simplified_nvars();
+    #ifndef _WIN32
+    const string tmp_suffix = ".tmp" + std::to_string(getpid());
+    #else
+    const string tmp_suffix = ".tmp";
+    #endif
+    const string cnf_fname = base + ".bcnf";
+    FILE* f = fopen((cnf_fname + tmp_suffix).c_str(), "wb");
+    if (f == nullptr) {
+        cout << "c WARNING: could not write preprocessing cache file '"
+        << cnf_fname << "': " << strerror(errno) << endl;
+        return;
+    }
+
+    bool written = true;
+    {
+        BinaryCnfWriter writer(f);
+        writer.set_num_vars(simp_nvars);
+        vector<Lit> lits;
+        vector<uint32_t> vars;
+        bool is_xor;
+        bool rhs;
+        solver->start_getting_constraints(false, true);
+        while (solver->get_next_constraint(lits, is_xor, rhs)) {
+            for(const Lit l: lits) if (l.var() >= simp_nvars) written = false;
+            if (is_xor) {
+                vars.clear();
+                for(const Lit l: lits) {
+                    vars.push_back(l.var());
+                    rhs ^= l.sign();
+                }
+                writer.add_xor_clause(vars, rhs);
+            } else {
+                writer.add_clause(lits);
             }
         }
-    } else {
-      for (const uint32_t var: solver->get_sampl_vars()) {
-          if (solver->get_model()[var] != l_Undef) {
-              lits.push_back( Lit(var, (solver->get_model()[var] == l_True)? true : false) );
-          }
-      }
+        solver->end_getting_constraints();
+        if (!writer.finish()) written = false;
+    }
+    if (fclose(f) != 0) written = false;
+
+    uint64_t cnf_hash = 0;
+    uint64_t cnf_size = 0;
+    if (written && !hash_file(cnf_fname + tmp_suffix, cnf_hash, cnf_size)) written = false;
+
+    OutArchive ar;
+    ar << preproc_cache_magic << key << cnf_hash << cnf_size << simp_nvars
+        << solver->serialize_solution_reconstruction_data();
+    const string rec_fname = base + ".rec";
+    std::ofstream rec((rec_fname + tmp_suffix).c_str(), std::ios::binary);
+    rec.write(ar.str().data(), ar.str().size());
+    rec.close();
+    if (!rec) written = false;
+
+    if (!written
+        || rename((cnf_fname + tmp_suffix).c_str(), cnf_fname.c_str()) != 0
+        || rename((rec_fname + tmp_suffix).c_str(), rec_fname.c_str()) != 0
+    ) {
+        cout << "c WARNING: could not write preprocessing cache entry '" << base << "'" << endl;
+        std::remove((cnf_fname + tmp_suffix).c_str());
+        std::remove((rec_fname + tmp_suffix).c_str());
+        return;
+    }
+    if (conf.verbosity) {
+        cout << "c Stored simplified CNF with " << simp_nvars << " variables in the preprocessing cache"
+        << " T: " << std::fixed << std::setprecision(2) << (cpuTime() - my_time) << endl;
     }
-    solver->add_clause(lits);
 }
 
 ///////////
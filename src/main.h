@@ -74,6 +74,7 @@ class Main: public MainCommon
 
         //File reading
         void readInAFile(SATSolver* solver2, const string& filename);
+        bool read_in_a_file_mmap(SATSolver* solver2, const string& filename);
         void readInStandardInput(SATSolver* solver2);
         void parseInAllFiles(SATSolver* solver2);
 
@@ -85,14 +86,28 @@ class Main: public MainCommon
         );
         void printVersionInfo();
         int correctReturnValue(const lbool ret) const;
+        bool close_proof();
         lbool multi_solutions();
-        void ban_found_solution();
+        bool single_run_possible() const;
+        static bool found_solution(void* state, const vector<lbool>& model);
+
+        //Preprocessing cache
+        bool preproc_cache_usable() const;
+        string preproc_cache_conf_key() const;
+        lbool solve_with_preproc_cache();
+        bool solve_from_preproc_cache(const string& base, const string& key, lbool& ret);
+        void fill_preproc_cache(const string& base, const string& key);
 
         //Config
         std::string debugLib;
+        unsigned parse_threads = 0;
+        string preproc_cache_dir;
+        string checkpoint_fname;
+        double checkpoint_every_secs = 600;
         int printResult = true;
         string commandLine;
         uint32_t max_nr_of_solutions = 1;
+        uint32_t nr_of_solutions = 0;
         bool dont_ban_solutions = false;
         int sql = 0;
         string sqlite_filename;
@@ -107,6 +122,9 @@ class Main: public MainCommon
         //Files to read & write
         bool fileNamePresent;
         string result_fname;
+        string binmodel_fname;
+        string telemetry_fname;
+        string trace_fname;
         string input_file;
         std::ofstream* resultfile = nullptr;
 
@@ -30,6 +30,23 @@ using std::endl;
 
 using namespace CMSat;
 
+// Proofs written to a ".gz" file are compressed on the proof writer thread
+static void set_proof_compression(const string& fname, SolverConf& conf)
+{
+    const string ext = ".gz";
+    if (fname.size() <= ext.size()
+        || fname.compare(fname.size()-ext.size(), ext.size(), ext) != 0
+    ) {
+        return;
+    }
+    #ifdef USE_ZLIB
+    conf.proof_gzip_level = 6;
+    #else
+    std::cerr << "ERROR: cannot write '" << fname << "', compiled without zlib" << endl;
+    std::exit(-1);
+    #endif
+}
+
 void MainCommon::handle_frat_option() {
     FILE* fratfTmp = fopen(frat_fname.c_str(), "wb");
     if (fratfTmp == nullptr) {
@@ -40,6 +57,7 @@ void MainCommon::handle_frat_option() {
         std::exit(-1);
     }
     fratf = fratfTmp;
+    set_proof_compression(frat_fname, conf);
 }
 
 void MainCommon::handle_idrup_option() {
@@ -53,24 +71,80 @@ void MainCommon::handle_idrup_option() {
         std::exit(-1);
     }
     idrupf = idrupfTmp;
+    set_proof_compression(idrup_fname, conf);
 }
 
-uint32_t MainCommon::print_model(CMSat::SATSolver* solver, std::ostream* os, const std::vector<uint32_t>* only)
+// Appends "-123 " style literals to a block buffer that is written out in
+// large chunks, so huge models are not pushed through the stream one
+// integer at a time
+namespace {
+class ModelPrinter {
+public:
+    ModelPrinter(std::ostream* _os, bool _v_lines) : os(_os), v_lines(_v_lines) {
+        buf.reserve(block_size + 64);
+        if (v_lines) start_line();
+    }
+
+    void add(uint32_t var, bool positive) {
+        char tmp[16];
+        char* end = tmp + sizeof(tmp);
+        char* p = end;
+        uint32_t x = var+1;
+        *--p = ' ';
+        do {
+            *--p = '0' + x % 10;
+            x /= 10;
+        } while(x);
+        if (!positive) *--p = '-';
+        const size_t len = end - p;
+
+        if (v_lines && line_size + len > 80) {
+            buf += '\n';
+            start_line();
+        }
+        line_size += len;
+        buf.append(p, len);
+        if (buf.size() >= block_size) write_out();
+    }
+
+    void finish() {
+        buf += "0\n";
+        write_out();
+        os->flush();
+    }
+
+private:
+    void start_line() {
+        buf += "v ";
+        line_size = 2;
+    }
+
+    void write_out() {
+        os->write(buf.data(), buf.size());
+        buf.clear();
+    }
+
+    static constexpr size_t block_size = 1U << 20;
+    std::ostream* os;
+    const bool v_lines;
+    std::string buf;
+    size_t line_size = 0;
+};
+}
+
+uint32_t MainCommon::print_model(
+    CMSat::SATSolver* solver,
+    std::ostream* os,
+    const std::vector<uint32_t>* only,
+    const bool v_lines)
 {
-    *os << "v ";
-    size_t line_size = 2;
+    const auto& model = solver->get_model();
+    ModelPrinter printer(os, v_lines);
     size_t num_undef = 0;
 
     auto fun = [&](uint32_t var) {
-        if (solver->get_model()[var] != CMSat::l_Undef) {
-            const bool value_is_positive = (solver->get_model()[var] == CMSat::l_True);
-            const size_t this_var_size = std::ceil(std::log10(var+1)) + 1 + !value_is_positive;
-            line_size += this_var_size;
-            if (line_size > 80) {
-                *os << std::endl << "v ";
-                line_size = 2 + this_var_size;
-            }
-            *os << (value_is_positive? "" : "-") << var+1 << " ";
+        if (model[var] != CMSat::l_Undef) {
+            printer.add(var, model[var] == CMSat::l_True);
         } else {
             num_undef++;
         }
@@ -85,6 +159,25 @@ uint32_t MainCommon::print_model(CMSat::SATSolver* solver, std::ostream* os, con
             fun(var);
         }
     }
-    *os << "0" << std::endl;
+    printer.finish();
     return num_undef;
 }
+
+bool MainCommon::write_binary_model(CMSat::SATSolver* solver, const string& fname)
+{
+    const auto& model = solver->get_model();
+    const uint64_t n = solver->nVars();
+    std::vector<uint8_t> vals(n);
+    for(uint64_t i = 0; i < n; i++) {
+        if (model[i] == CMSat::l_True) vals[i] = 1;
+        else if (model[i] == CMSat::l_False) vals[i] = 0;
+        else vals[i] = 2;
+    }
+
+    std::ofstream f(fname.c_str(), std::ios::binary);
+    f.write(binary_model_magic, 8);
+    f.write((const char*)&n, sizeof(n));
+    f.write((const char*)vals.data(), vals.size());
+    f.close();
+    return (bool)f;
+}
@@ -32,9 +32,18 @@ THE SOFTWARE.
 class MainCommon
 {
 public:
+    // Prints the model as "v" lines, or as a single line without the "v"
+    // prefix if v_lines is false. Returns the number of unset variables
     static uint32_t print_model(CMSat::SATSolver* solver,
                          std::ostream* os,
-                         const std::vector<uint32_t>* only = nullptr);
+                         const std::vector<uint32_t>* only = nullptr,
+                         bool v_lines = true);
+
+    // Binary model for machine consumers: the 8-byte magic "CMSMODL1",
+    // the number of variables as a native 64-bit integer, then one byte
+    // per variable: 1 = true, 0 = false, 2 = unset
+    static constexpr const char* binary_model_magic = "CMSMODL1";
+    static bool write_binary_model(CMSat::SATSolver* solver, const string& fname);
     void handle_frat_option();
     void handle_idrup_option();
 
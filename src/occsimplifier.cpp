@@ -881,6 +881,7 @@ bool OccSimplifier::can_eliminate_var(const uint32_t var, bool ignore_xor) const
     if (solver->value(var) != l_Undef ||
         solver->varData[var].removed != Removed::none ||
         solver->var_inside_assumptions(var) != l_Undef ||
+        solver->varData[var].observed ||
         (!ignore_xor && xorclauses_vars[var]) ||
         ((solver->conf.sampling_vars_set || solver->fast_backw.fast_backw_on) &&
             sampling_vars_occsimp[var])
@@ -1364,6 +1365,7 @@ bool OccSimplifier::eliminate_vars()
 
             //These WILL ADD VARS BACK even though it's not changed.
             for(uint32_t var: removed_cl_with_var.getTouchedList()) {
+                if (incremental_run) touched_since_last_run.touch(var);
                 if (!can_eliminate_var(var)) continue;
                 varElimComplexity[var] = heuristicCalcVarElimScore(var);
                 velim_order.update(var);
@@ -2286,6 +2288,8 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
             cout << "c --> Executing OCC strategy token: " << token << '\n';
             *solver->frat << __PRETTY_FUNCTION__ << " Executing OCC strategy token:" << token.c_str() << "\n";
         }
+        const PhaseSnapshot before = solver->phase_snapshot();
+        TraceSpan span(token.empty() ? nullptr : solver->trace, token);
 
         if (token == "occ-backw-sub-str") {
             backward_sub_str();
@@ -2321,7 +2325,10 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
         } else if (token == "occ-bve") {
             if (solver->conf.doVarElim) {
                 if (solver->conf.do_empty_varelim) eliminate_empty_resolvent_vars();
-                if (solver->conf.do_full_varelim) if (!eliminate_vars()) continue;
+                if (solver->conf.do_full_varelim && !eliminate_vars()) {
+                    solver->telemetry.add(token, before, solver->phase_snapshot());
+                    continue;
+                }
                 if (solver->conf.do_xor_varelim) eliminate_xor_vars();
             }
         } else if (token == "occ-rem-with-orgates") {
@@ -2338,6 +2345,8 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
              cout << "ERROR: occur strategy '" << token << "' not recognised!" << endl;
             exit(-1);
         }
+        if (!token.empty()) solver->telemetry.add(token, before, solver->phase_snapshot());
+        check_run_complete(token);
         CHECK_N_OCCUR_DO(check_n_occur());
         SLOW_DEBUG_DO(check_cls_sanity());
         SLOW_DEBUG_DO(solver->check_no_removed_or_freed_cl_in_watch());
@@ -2347,7 +2356,7 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
     return solver->okay();
 }
 
-bool OccSimplifier::setup() {
+bool OccSimplifier::setup(const string* schedule) {
     frat_func_start();
     assert(solver->okay());
     assert(solver->prop_at_head());
@@ -2372,6 +2381,10 @@ bool OccSimplifier::setup() {
     }
 
     if (!solver->clauseCleaner->remove_and_clean_all()) return false;
+    if (schedule && !mark_touched_since_last_run(*schedule)) {
+        verb_print(1, "[occ] no irred clause changed since the last run, skipping");
+        return false;
+    }
     solver->clear_gauss_matrices(false);
     for(auto& gw: solver->gwatches) gw.clear();
     for(const auto& x: solver->xorclauses) for(const auto& v: x) xorclauses_vars[v] = 1;
@@ -2390,6 +2403,118 @@ bool OccSimplifier::setup() {
     return solver->okay();
 }
 
+static inline uint64_t lit_sig_hash(const Lit lit)
+{
+    uint64_t x = lit.toInt() + 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Each outer var gets the sum of the hashes of the irred clauses it is in.
+// Clause hashes use outer literals and don't depend on literal order, so
+// renumbering and watch-driven reordering between runs don't change them.
+// Must be called with the clauses attached normally, i.e. outside a run
+void OccSimplifier::calc_var_sigs(vector<uint64_t>& sigs) const
+{
+    sigs.clear();
+    sigs.resize(solver->nVarsOuter(), 0);
+
+    //Whether can_eliminate_var() allows a var doesn't only depend on its
+    //clauses. A var that became eligible must be tried again.
+    vector<uint8_t> blocked(solver->nVarsOuter(), 0);
+    if (solver->conf.sampling_vars_set) {
+        for(const uint32_t v: solver->conf.sampling_vars) {
+            const uint32_t outer = solver->varReplacer->get_var_replaced_with_outer(v);
+            if (outer < blocked.size()) blocked[outer] |= 1;
+        }
+    }
+    for(const auto& x: solver->xorclauses) {
+        for(const uint32_t v: x) blocked[solver->map_inter_to_outer(v)] |= 2;
+    }
+    for(uint32_t i = 0; i < solver->nVars(); i++) {
+        const uint32_t outer = solver->map_inter_to_outer(i);
+        if (solver->var_inside_assumptions(i) != l_Undef) blocked[outer] |= 4;
+        if (solver->varData[i].observed) blocked[outer] |= 8;
+        sigs[outer] = lit_sig_hash(Lit::toLit(blocked[outer]));
+    }
+    for(const ClOffset offs: solver->longIrredCls) {
+        const Clause& cl = *solver->cl_alloc.ptr(offs);
+        uint64_t h = cl.size();
+        for(const Lit l: cl) h += lit_sig_hash(solver->map_inter_to_outer(l));
+        for(const Lit l: cl) sigs[solver->map_inter_to_outer(l.var())] += h;
+    }
+
+    for(uint32_t i = 0; i < solver->nVars()*2; i++) {
+        const Lit lit = Lit::toLit(i);
+        for(const Watched& w: solver->watches[lit]) {
+            if (!w.isBin() || w.red() || lit > w.lit2()) continue;
+            const uint64_t h = 2
+                + lit_sig_hash(solver->map_inter_to_outer(lit))
+                + lit_sig_hash(solver->map_inter_to_outer(w.lit2()));
+            sigs[solver->map_inter_to_outer(lit.var())] += h;
+            sigs[solver->map_inter_to_outer(w.lit2().var())] += h;
+        }
+    }
+}
+
+// Returns false if this run can be skipped: it only does BVE, with the same
+// schedule as the last one, that one finished within its limits, and no var
+// changed since. Otherwise, if the run can be incremental, sets up
+// touched_since_last_run to contain the vars whose irred clauses or whose
+// eligibility for elimination changed. Only BVE is restricted to them.
+bool OccSimplifier::mark_touched_since_last_run(const string& schedule)
+{
+    incremental_run = false;
+    touched_since_last_run.clear();
+    if (!solver->conf.occ_incremental
+        || startup
+        || !last_run_complete
+        || var_sig_outer.empty()
+        || schedule != last_schedule
+        || solver->fast_backw.fast_backw_on
+    ) {
+        return true;
+    }
+
+    const double my_time = cpuTime();
+    vector<uint64_t> sigs;
+    calc_var_sigs(sigs);
+    var_sig_outer.resize(sigs.size(), 0);
+    for(uint32_t i = 0; i < solver->nVars(); i++) {
+        const uint32_t outer = solver->map_inter_to_outer(i);
+        if (sigs[outer] != var_sig_outer[outer]) touched_since_last_run.touch(i);
+    }
+    const size_t num_touched = touched_since_last_run.getTouchedList().size();
+    verb_print(1, "[occ] incremental run, vars touched since the last run: "
+        << num_touched << "/" << solver->nVars()
+        << solver->conf.print_times(cpuTime()-my_time));
+    incremental_run = true;
+    if (num_touched > 0) return true;
+
+    //Subsumption etc. have new learnt clauses to work on every time
+    std::istringstream ss(schedule + ",");
+    std::string token;
+    while(std::getline(ss, token, ',')) {
+        token = trim(token);
+        if (!token.empty() && token != "occ-bve") return true;
+    }
+    incremental_run = false;
+    return false;
+}
+
+// A BVE run cut short by its limits may have left untouched vars untried,
+// so the next run must not be incremental
+void OccSimplifier::check_run_complete(const string& token)
+{
+    if (token == "occ-bve" && solver->conf.doVarElim) {
+        if (norm_varelim_time_limit <= 0
+            || varelim_num_limit <= 0
+            || varelim_linkin_limit_bytes <= 0
+        ) last_run_complete = false;
+    }
+}
+
 bool OccSimplifier::simplify(const bool _startup, const std::string& schedule) {
     if (!solver->bnns.empty()) return solver->okay();
     DEBUG_MARKED_CLAUSE_DO(assert(solver->no_marked_clauses()));
@@ -2398,7 +2523,7 @@ bool OccSimplifier::simplify(const bool _startup, const std::string& schedule) {
     assert(solver->gqueuedata.empty());
 
     startup = _startup;
-    if (!setup()) return solver->okay();
+    if (!setup(&schedule)) return solver->okay();
 
     const size_t origElimedSize = elimed_cls.size();
     const size_t origTrailSize = solver->trail_size();
@@ -2457,11 +2582,18 @@ bool OccSimplifier::simplify(const bool _startup, const std::string& schedule) {
     }
 
     last_trail_cleared = solver->getTrailSize();
+    last_run_complete = true;
     execute_simplifier_strategy(schedule);
 
     remove_by_frat_recently_elimed_clauses(origElimedSize);
     finish_up(origTrailSize);
 
+    last_schedule = schedule;
+    if (solver->okay() && solver->conf.occ_incremental) calc_var_sigs(var_sig_outer);
+    else var_sig_outer.clear();
+    incremental_run = false;
+    touched_since_last_run.clear();
+
     return solver->okay();
 }
 
@@ -5187,7 +5319,7 @@ void OccSimplifier::order_vars_for_elim()
         ; var < solver->nVars() && *limit_to_decrease > 0
         ; var++
     ) {
-        if (!can_eliminate_var(var)) continue;
+        if (!can_eliminate_var(var) || !touched_since_last(var)) continue;
 
         *limit_to_decrease -= 50;
         assert(!velim_order.inHeap(var));
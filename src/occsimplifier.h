@@ -218,18 +218,16 @@ public:
     void free_clauses_to_free();
 
     //Setup and teardown. Should be private, but testing needs it to be public
-    bool setup();
+    bool setup(const string* schedule = nullptr);
     void finish_up(size_t origTrailSize);
 
     //Ternary resolution. Should be private but testing needs it to be public
     bool ternary_res();
 
-#ifdef ARJUN_SERIALIZE
     template<class T>
     void serialize_elimed_cls  (T& ar) const;
     template<class T>
     void unserialize_elimed_cls(T& ar);
-#endif
 
 private:
     friend class SubsumeStrengthen;
@@ -237,6 +235,20 @@ private:
     void check_cls_sanity();
 
     bool startup = false;
+
+    //Incremental runs, see conf.occ_incremental
+    vector<uint64_t> var_sig_outer; ///<Irred clauses and elim eligibility of each outer var at end of last run
+    string last_schedule;
+    bool last_run_complete = false;
+    bool incremental_run = false;
+    TouchList touched_since_last_run;
+    void calc_var_sigs(vector<uint64_t>& sigs) const;
+    bool mark_touched_since_last_run(const string& schedule);
+    void check_run_complete(const string& token);
+    bool touched_since_last(const uint32_t var) const {
+        return !incremental_run || touched_since_last_run.touched_var(var);
+    }
+
     bool backward_sub_str();
     void backward_sub();
     bool execute_simplifier_strategy(const string& strategy);
@@ -582,20 +594,21 @@ inline const SubsumeStrengthen* OccSimplifier::get_sub_str() const
     return sub_str;
 }
 
-#ifdef ARJUN_SERIALIZE
 template<class T>
 void OccSimplifier::unserialize_elimed_cls(T& ar)
 {
-    ar >> eClsLits;
-    ar >> elimedClauses;
+    ar >> elimed_cls_lits;
+    ar >> elimed_cls;
+    ar >> bvestats_global.numVarsElimed;
+    elimed_map_built = false;
 }
 
 template<class T>
 void OccSimplifier::serialize_elimed_cls(T& ar) const
 {
-    ar << eClsLits;
-    ar << elimedClauses;
+    ar << elimed_cls_lits;
+    ar << elimed_cls;
+    ar << bvestats_global.numVarsElimed;
 }
-#endif
 
 } //end namespace
@@ -22,8 +22,14 @@ THE SOFTWARE.
 
 #include "solver.h"
 #include "oracle/oracle.h"
+#include "time_mem.h"
+
+#include <thread>
+#include <mutex>
+#include <memory>
 
 using namespace CMSat;
+using std::thread;
 
 inline vector<int> negate(vector<int> vec) {
 	for (int& lit : vec) lit = sspp::Neg(lit);
@@ -74,6 +80,199 @@ vector<vector<int>> Solver::get_irred_cls_for_oracle() const
     return clauses;
 }
 
+bool Solver::add_back_oracle_cls(const vector<vector<int>>& clauses, const bool red)
+{
+    vector<Lit> tmp2;
+    for(const auto& cl: clauses) {
+        tmp2.clear();
+        for(const auto& l: cl) tmp2.push_back(orc_to_lit(l));
+        if (!red) {
+            Clause* cl2 = solver->add_clause_int(tmp2);
+            if (cl2) longIrredCls.push_back(cl_alloc.get_offset(cl2));
+        } else {
+            ClauseStats s;
+            s.which_red_array = 2;
+            s.ID = ++clauseID;
+            s.glue = cl.size();
+            Clause* cl2 = solver->add_clause_int(tmp2, true, &s);
+            if (cl2) longRedCls[2].push_back(cl_alloc.get_offset(cl2));
+        }
+        if (!okay()) return false;
+    }
+    return true;
+}
+
+namespace {
+
+//Units learnt by any of the oracles, so the others can use them too
+struct OracleSharedUnits {
+    std::mutex mu;
+    vector<int> units;
+    bool unsat = false;
+};
+
+//Vivifies every nthreads-th clause with its own oracle over the whole CNF.
+//Strengthened clauses are written back to their own slot only, so workers
+//never touch the same element of the shared clause vector.
+struct OracleVivifWorker {
+    OracleVivifWorker(
+        const int _nvars,
+        const vector<vector<int>>& _orig,
+        vector<vector<int>>& _clauses,
+        const uint32_t _tid,
+        const uint32_t _nthreads,
+        OracleSharedUnits& _shared,
+        const uint32_t _verb) :
+        nvars(_nvars), orig(_orig), clauses(_clauses), tid(_tid)
+        , nthreads(_nthreads), shared(_shared), verb(_verb)
+    {}
+
+    void operator()()
+    {
+        oracle = std::make_unique<sspp::oracle::Oracle>(nvars, orig, vector<vector<int>>{});
+        oracle->SetVerbosity(verb);
+        known.resize(nvars+1, 0);
+        for (size_t i = tid; i < clauses.size(); i += nthreads) {
+            for (int j = 0; j < (int)clauses[i].size(); j++) {
+                if (oracle->getStats().mems > 1600LL*1000LL*1000LL) return;
+                if (!sync_units()) return;
+                auto assump = negate(clauses[i]);
+                swapdel(assump, j);
+                auto ret = oracle->Solve(assump, true, 500LL*1000LL*1000LL);
+                if (ret.isUnknown()) return;
+                if (ret.isFalse()) {
+                    sort(assump.begin(), assump.end());
+                    auto clause = negate(assump);
+                    oracle->AddClauseIfNeededAndStr(clause, true);
+                    clauses[i] = clause;
+                    j = -1; //start from beginning
+                    if (clause.empty()) {
+                        set_unsat();
+                        return;
+                    }
+                }
+            }
+        }
+        finished = true;
+    }
+
+    //Publishes the units this oracle learnt since the last call and imports
+    //the ones the others published. Returns false if the CNF is UNSAT.
+    bool sync_units()
+    {
+        if (oracle->getStats().learned_units != units_at) {
+            units_at = oracle->getStats().learned_units;
+            for (int v = 1; v <= nvars; v++) {
+                if (known[v]) continue;
+                const int val = oracle->LitVal(sspp::PosLit(v));
+                if (val == 0) continue;
+                known[v] = 1;
+                to_publish.push_back(val == 1 ? sspp::PosLit(v) : sspp::NegLit(v));
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(shared.mu);
+            if (shared.unsat) return false;
+            shared.units.insert(shared.units.end(), to_publish.begin(), to_publish.end());
+            for(; imported_at < shared.units.size(); imported_at++) {
+                const int u = shared.units[imported_at];
+                if (!known[sspp::VarOf(u)]) to_import.push_back(u);
+            }
+        }
+        to_publish.clear();
+
+        for(const int u: to_import) {
+            known[sspp::VarOf(u)] = 1;
+            if (!oracle->FreezeUnit(u)) {
+                to_import.clear();
+                set_unsat();
+                return false;
+            }
+        }
+        to_import.clear();
+        units_at = oracle->getStats().learned_units;
+        return true;
+    }
+
+    void set_unsat()
+    {
+        std::lock_guard<std::mutex> lock(shared.mu);
+        shared.unsat = true;
+    }
+
+    const int nvars;
+    const vector<vector<int>>& orig;
+    vector<vector<int>>& clauses;
+    const uint32_t tid;
+    const uint32_t nthreads;
+    OracleSharedUnits& shared;
+    const uint32_t verb;
+
+    std::unique_ptr<sspp::oracle::Oracle> oracle;
+    bool finished = false;
+    vector<char> known;
+    vector<int> to_publish;
+    vector<int> to_import;
+    size_t imported_at = 0;
+    int64_t units_at = 0;
+};
+
+}
+
+bool Solver::oracle_vivif_parallel(
+    vector<vector<int>>& clauses, bool& finished, const uint32_t nthreads)
+{
+    const double my_time = real_time_sec();
+    const vector<vector<int>> orig = clauses;
+    OracleSharedUnits shared;
+    vector<OracleVivifWorker> workers;
+    workers.reserve(nthreads);
+    for(uint32_t i = 0; i < nthreads; i++) {
+        workers.emplace_back(nVars(), orig, clauses, i, nthreads, shared, conf.verbosity);
+    }
+    vector<thread> thds;
+    for(auto& w: workers) thds.push_back(thread(std::ref(w)));
+    for(std::thread& t: thds) t.join();
+
+    if (shared.unsat) {
+        ok = false;
+        return false;
+    }
+    bool all_finished = true;
+    for(const auto& w: workers) all_finished &= w.finished;
+    finished |= all_finished;
+    oracle_par_threads = nthreads;
+    oracle_par_shared_units = shared.units.size();
+
+    if (!add_back_oracle_cls(clauses, false)) return false;
+    vector<vector<int>> units;
+    for(const int u: shared.units) units.push_back({u});
+    if (!add_back_oracle_cls(units, false)) return false;
+    if (conf.oracle_get_learnts) {
+        for(const auto& w: workers) {
+            if (!add_back_oracle_cls(w.oracle->GetLearnedClauses(), true)) return false;
+        }
+    }
+
+    int64_t cache_useful = 0;
+    int64_t cache_added = 0;
+    int64_t mems = 0;
+    for(const auto& w: workers) {
+        cache_useful += w.oracle->getStats().cache_useful;
+        cache_added += w.oracle->getStats().cache_added;
+        mems += w.oracle->getStats().mems;
+    }
+    verb_print(1, "[oracle-vivif] threads: " << nthreads
+            << " cache-used: " << cache_useful
+            << " cache-added: " << cache_added
+            << " shared-units: " << shared.units.size()
+            << " mems: " << print_value_kilo_mega(mems)
+            << " finished (vivif or backbone): " << finished
+            << " wallT: " << std::setprecision(2) << (real_time_sec()-my_time));
+    return solver->okay();
+}
+
 bool Solver::oracle_vivif(bool& finished)
 {
     assert(!frat->enabled());
@@ -89,6 +288,12 @@ bool Solver::oracle_vivif(bool& finished)
     auto clauses = get_irred_cls_for_oracle();
     detach_and_free_all_irred_cls();
 
+    //Every worker holds a copy of the CNF, so stay serial under memory pressure
+    uint32_t nthreads = mem_pressure ? 1 : std::max<uint32_t>(1, conf.oracle_threads);
+    if (thread::hardware_concurrency() > 0)
+        nthreads = std::min<uint32_t>(nthreads, thread::hardware_concurrency());
+    if (nthreads > 1) return oracle_vivif_parallel(clauses, finished, nthreads);
+
     sspp::oracle::Oracle oracle(nVars(), clauses, {});
     oracle.SetVerbosity(conf.verbosity);
     bool sat = false;
@@ -119,27 +324,9 @@ bool Solver::oracle_vivif(bool& finished)
     finished |= true;
 
     end:
-    vector<Lit> tmp2;
-    for(const auto& cl: clauses) {
-        tmp2.clear();
-        for(const auto& l: cl) tmp2.push_back(orc_to_lit(l));
-        Clause* cl2 = solver->add_clause_int(tmp2);
-        if (cl2) longIrredCls.push_back(cl_alloc.get_offset(cl2));
-        if (!okay()) return false;
-    }
-
+    if (!add_back_oracle_cls(clauses, false)) return false;
     if (conf.oracle_get_learnts) {
-        for (const auto& cl: oracle.GetLearnedClauses()) {
-            tmp2.clear();
-            for(const auto& l: cl) tmp2.push_back(orc_to_lit(l));
-            ClauseStats s;
-            s.which_red_array = 2;
-            s.ID = ++clauseID;
-            s.glue = cl.size();
-            Clause* cl2 = solver->add_clause_int(tmp2, true, &s);
-            if (cl2) longRedCls[2].push_back(cl_alloc.get_offset(cl2));
-            if (!okay()) return false;
-        }
+        if (!add_back_oracle_cls(oracle.GetLearnedClauses(), true)) return false;
     }
 
     verb_print(1, "[oracle-vivif] finished: " << finished
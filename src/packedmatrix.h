@@ -102,6 +102,11 @@ public:
         return *this;
     }
 
+    size_t mem_used() const
+    {
+        return sizeof(int64_t)*numRows*(numCols+1);
+    }
+
     inline PackedRow operator[](const uint32_t i)
     {
         #ifdef DEBUG_MATRIX
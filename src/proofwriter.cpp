@@ -0,0 +1,225 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "proofwriter.h"
+#include "solvertypes.h"
+#include "time_mem.h"
+
+#include <cassert>
+#include <iostream>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace CMSat;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+ProofWriter::ProofWriter(const size_t _buf_size, const uint32_t num_bufs) :
+    buf_size(_buf_size)
+{
+    assert(num_bufs >= 2);
+    for(uint32_t i = 0; i < num_bufs; i++) {
+        unsigned char* b = new unsigned char[buf_size];
+        all_bufs.push_back(b);
+        free_bufs.push_back(b);
+    }
+    thd = std::thread(&ProofWriter::writer_thread, this);
+}
+
+ProofWriter::~ProofWriter()
+{
+    finish();
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        stop = true;
+    }
+    cond_job.notify_one();
+    thd.join();
+    for(unsigned char* b: all_bufs) delete[] b;
+
+    #ifdef USE_ZLIB
+    if (zstrm) {
+        deflateEnd((z_stream*)zstrm);
+        delete (z_stream*)zstrm;
+    }
+    #endif
+}
+
+bool ProofWriter::set_gzip(const int level)
+{
+    assert(num_submitted == 0);
+    #ifdef USE_ZLIB
+    if (level <= 0) return true;
+    z_stream* z = new z_stream;
+    z->zalloc = Z_NULL;
+    z->zfree = Z_NULL;
+    z->opaque = Z_NULL;
+    // 15+16: gzip header, so the result can be read with zcat
+    if (deflateInit2(z, std::min(level, 9), Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        delete z;
+        return false;
+    }
+    zstrm = z;
+    gzip_level = level;
+    zout.resize(buf_size + 1024);
+    return true;
+    #else
+    return level <= 0;
+    #endif
+}
+
+unsigned char* ProofWriter::first_buf()
+{
+    std::lock_guard<std::mutex> lock(mu);
+    assert(!free_bufs.empty());
+    unsigned char* b = free_bufs.back();
+    free_bufs.pop_back();
+    return b;
+}
+
+void ProofWriter::push_job(const Job& j)
+{
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        jobs.push_back(j);
+        num_submitted++;
+    }
+    cond_job.notify_one();
+}
+
+unsigned char* ProofWriter::submit(unsigned char* buf, const size_t len)
+{
+    assert(len <= buf_size);
+    bytes_in += len;
+    push_job(Job{buf, len, false, false});
+
+    std::unique_lock<std::mutex> lock(mu);
+    if (free_bufs.empty()) {
+        // Backpressure: the disk (or compression) is slower than the solver
+        const double my_time = real_time_sec();
+        num_blocked++;
+        cond_done.wait(lock, [&]{ return !free_bufs.empty(); });
+        time_blocked += real_time_sec() - my_time;
+    }
+    unsigned char* b = free_bufs.back();
+    free_bufs.pop_back();
+    return b;
+}
+
+void ProofWriter::sync()
+{
+    if (finished) return;
+    const double my_time = real_time_sec();
+    push_job(Job{nullptr, 0, true, false});
+    std::unique_lock<std::mutex> lock(mu);
+    const uint64_t ticket = num_submitted;
+    cond_done.wait(lock, [&]{ return num_done >= ticket; });
+    time_blocked += real_time_sec() - my_time;
+}
+
+void ProofWriter::finish()
+{
+    if (finished) return;
+    push_job(Job{nullptr, 0, true, true});
+    std::unique_lock<std::mutex> lock(mu);
+    const uint64_t ticket = num_submitted;
+    cond_done.wait(lock, [&]{ return num_done >= ticket; });
+    finished = true;
+
+    // The proof is useless, whatever the verbosity
+    if (write_failed) cerr << "ERROR: writing the proof failed" << endl;
+}
+
+void ProofWriter::writer_thread()
+{
+    while(true) {
+        Job j;
+        {
+            std::unique_lock<std::mutex> lock(mu);
+            cond_job.wait(lock, [&]{ return stop || !jobs.empty(); });
+            if (jobs.empty()) return;
+            j = jobs.front();
+            jobs.pop_front();
+        }
+
+        const double my_time = real_time_sec();
+        bool failed = false;
+        const size_t written = write_out(j.buf, j.len, j.sync, j.end, failed);
+        const double write_time = real_time_sec() - my_time;
+
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            time_writing += write_time;
+            bytes_out += written;
+            write_failed |= failed;
+            if (j.buf) free_bufs.push_back(j.buf);
+            num_done++;
+        }
+        cond_done.notify_all();
+    }
+}
+
+size_t ProofWriter::write_out(
+    const unsigned char* buf, const size_t len, const bool sync, const bool end,
+    bool& failed)
+{
+    if (file == nullptr) return 0;
+    size_t written = 0;
+
+    #ifdef USE_ZLIB
+    if (zstrm) {
+        z_stream* z = (z_stream*)zstrm;
+        z->next_in = (Bytef*)buf;
+        z->avail_in = len;
+        const int mode = end ? Z_FINISH : ((sync || flush_every_buf) ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+        int ret;
+        do {
+            z->next_out = zout.data();
+            z->avail_out = zout.size();
+            ret = deflate(z, mode);
+            const size_t num = zout.size() - z->avail_out;
+            if (num > 0 && fwrite(zout.data(), 1, num, file) != num) failed = true;
+            written += num;
+        } while (z->avail_out == 0 || (end && ret != Z_STREAM_END && ret != Z_STREAM_ERROR));
+        if (sync || flush_every_buf || end) fflush(file);
+        return written;
+    }
+    #endif
+
+    if (len > 0 && fwrite(buf, 1, len, file) != len) failed = true;
+    written += len;
+    if (sync || flush_every_buf) fflush(file);
+    return written;
+}
+
+void ProofWriter::print_stats() const
+{
+    std::lock_guard<std::mutex> lock(mu);
+    print_stats_line("c proof written MB", (double)bytes_out/(1024.0*1024.0),
+        float_div(bytes_out, bytes_in)*100.0, "% of generated");
+    print_stats_line("c proof write blocked T", time_blocked,
+        num_blocked, "times pool was full");
+    print_stats_line("c proof write T", time_writing, "(on writer thread)");
+}
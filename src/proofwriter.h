@@ -0,0 +1,106 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace CMSat {
+
+// Writes proof buffers to the proof file on a background thread. The
+// proof generator fills a buffer, hands it over with submit() and gets an
+// empty one back, so the solving thread only blocks on I/O when all
+// buffers of the pool are waiting to be written. Optionally gzip
+// compresses on the writer thread.
+class ProofWriter
+{
+public:
+    ProofWriter(size_t buf_size, uint32_t num_bufs);
+    ~ProofWriter();
+    ProofWriter(const ProofWriter&) = delete;
+    ProofWriter& operator=(const ProofWriter&) = delete;
+
+    // Must be called before anything is submitted
+    void set_file(FILE* f) { file = f; }
+    void set_flush_every_buf(bool b) { flush_every_buf = b; }
+    // Returns false if compression is not available in this build
+    bool set_gzip(int level);
+
+    // The buffer to fill first. Each buffer is buf_size bytes
+    unsigned char* first_buf();
+    // Queues "len" bytes of "buf" for writing, returns an empty buffer
+    unsigned char* submit(unsigned char* buf, size_t len);
+    // Waits until all submitted data is in the file (and fflush()-ed)
+    void sync();
+    // Writes everything and closes the compressed stream, if any. The file
+    // itself is not closed, that is up to its owner. A failed write is
+    // reported on stderr
+    void finish();
+
+    void print_stats() const;
+
+private:
+    struct Job {
+        unsigned char* buf;
+        size_t len;
+        bool sync;
+        bool end;
+    };
+    void writer_thread();
+    size_t write_out(const unsigned char* buf, size_t len, bool sync, bool end, bool& failed);
+    void push_job(const Job& j);
+
+    FILE* file = nullptr;
+    bool flush_every_buf = false;
+    int gzip_level = 0;
+    void* zstrm = nullptr;
+    std::vector<unsigned char> zout;
+
+    const size_t buf_size;
+    std::vector<unsigned char*> all_bufs;
+    std::vector<unsigned char*> free_bufs;
+    std::deque<Job> jobs;
+    bool stop = false;
+    bool finished = false;
+    uint64_t num_submitted = 0;
+    uint64_t num_done = 0;
+    mutable std::mutex mu;
+    std::condition_variable cond_job;
+    std::condition_variable cond_done;
+    std::thread thd;
+
+    //Stats
+    uint64_t bytes_in = 0;
+    uint64_t bytes_out = 0;
+    uint64_t num_blocked = 0;
+    double time_blocked = 0;
+    double time_writing = 0;
+    bool write_failed = false;
+};
+
+}
@@ -37,7 +37,7 @@ namespace CMSat {
 
 enum PropByType {
     null_clause_t = 0, clause_t = 1, binary_t = 2,
-    xor_t = 3, bnn_t = 4
+    xor_t = 3, bnn_t = 4, ext_t = 5
 };
 
 class PropBy
@@ -58,6 +58,7 @@ class PropBy
         //2: binary
         //3: xor
         //4: bnn
+        //5: external propagator
         uint32_t data2:bitsize_data2;
         int32_t ID;
 
@@ -139,6 +140,16 @@ class PropBy
         {
         }
 
+        //External propagator prop, the reason is asked for lazily
+        explicit PropBy(const PropByType _type):
+            red_step(0)
+            , data1(0xfffffff)
+            , type(_type)
+            , data2(0)
+        {
+            assert(_type == ext_t);
+        }
+
         //Binary prop
         PropBy(const Lit lit, const bool redStep, int32_t _ID) :
             red_step(redStep)
@@ -204,6 +215,29 @@ class PropBy
             return data2;
         }
 
+        void set_ext_reason(uint32_t idx)
+        {
+            assert(isExt());
+            data1 = idx;
+        }
+
+        bool ext_reason_set() const
+        {
+            assert(isExt());
+            return data1 != 0xfffffff;
+        }
+
+        uint32_t get_ext_reason() const
+        {
+            assert(ext_reason_set());
+            return data1;
+        }
+
+        bool isExt() const
+        {
+            return type == ext_t;
+        }
+
         bool isRedStep() const
         {
             return red_step;
@@ -332,6 +366,10 @@ inline std::ostream& operator<<(std::ostream& os, const PropBy& pb)
             os << " BNN reason, bnn idx: " << pb.get_bnn_reason();
             break;
 
+        case ext_t:
+            os << " external propagator reason";
+            break;
+
         case xor_t:
             os << " xor reason, matrix= " << pb.get_matrix_num() << " row: " << pb.get_row_num();
             break;
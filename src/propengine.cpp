@@ -386,6 +386,17 @@ lbool PropEngine::bnn_prop(
     return l_Undef;
 }
 
+uint32_t PropEngine::get_empty_bnn_reason_slot()
+{
+    if (bnn_reasons_empty_slots.empty()) {
+        bnn_reasons.push_back(vector<Lit>());
+        return bnn_reasons.size()-1;
+    }
+    const uint32_t empty_slot = bnn_reasons_empty_slots.back();
+    bnn_reasons_empty_slots.pop_back();
+    return empty_slot;
+}
+
 vector<Lit>* PropEngine::get_bnn_reason(BNN* bnn, Lit lit)
 {
 //     cout << "Getting BNN reason, lit: " << lit << " bnn: " << *bnn << endl;
@@ -414,18 +425,8 @@ vector<Lit>* PropEngine::get_bnn_reason(BNN* bnn, Lit lit)
         return &bnn_reasons[reason.get_bnn_reason()];
     }
 
-    vector<Lit>* ret;
-
-    //Get an empty slot
-    uint32_t empty_slot;
-    if (bnn_reasons_empty_slots.empty()) {
-        bnn_reasons.push_back(vector<Lit>());
-        empty_slot = bnn_reasons.size()-1;
-    } else {
-        empty_slot = bnn_reasons_empty_slots.back();
-        bnn_reasons_empty_slots.pop_back();
-    }
-    ret = &bnn_reasons[empty_slot];
+    const uint32_t empty_slot = get_empty_bnn_reason_slot();
+    vector<Lit>* ret = &bnn_reasons[empty_slot];
     reason.set_bnn_reason(empty_slot);
 
     get_bnn_prop_reason(bnn, lit, ret);
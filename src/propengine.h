@@ -286,6 +286,7 @@ protected:
     // Operations on clauses:
     /////////////////
     vector<Lit>* get_bnn_reason(BNN* bnn, Lit lit);
+    uint32_t get_empty_bnn_reason_slot();
     void get_bnn_confl_reason(BNN* bnn, vector<Lit>* ret);
     void get_bnn_prop_reason(BNN* bnn, Lit lit, vector<Lit>* ret);
     lbool bnn_prop(
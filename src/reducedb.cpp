@@ -247,6 +247,7 @@ void ReduceDB::gather_normal_cl_use_stats()
 //kept no. of clauses as other solvers do
 void ReduceDB::handle_lev2()
 {
+    TraceSpan span(solver->trace, "reducedb-lev2");
     solver->dump_memory_stats_to_sql();
     size_t orig_size = solver->longRedCls[2].size();
 
@@ -532,6 +533,7 @@ void ReduceDB::dump_sql_cl_data(
 
 void ReduceDB::handle_lev1()
 {
+    TraceSpan span(solver->trace, "reducedb-lev1");
     #ifdef VERBOSE_DEBUG
     cout << "c handle_lev1()" << endl;
     #endif
@@ -43,23 +43,44 @@ SCCFinder::SCCFinder(Solver* _solver) :
 bool SCCFinder::performSCC(uint64_t* bogoprops_given)
 {
     assert(binxors.empty());
+
+    //The components found last time have been replaced by now, so any new
+    //equivalence is on a cycle through the edge of a binary added since.
+    //Removing binaries or setting vars cannot create one. Starting Tarjan
+    //at the tails of the new edges is then enough to find all of them.
+    const bool incremental = solver->conf.inprocess_incremental
+        && last_run_complete
+        && !solver->journal.all_changed_since(journal_at);
+    if (incremental && !solver->journal.bin_added_since(journal_at)) {
+        verb_print(2, "[scc] no binary added since the last run, skipping");
+        return solver->okay();
+    }
+    if (incremental) solver->journal.bin_lits_since(journal_at, solver->nVars(), roots);
+    journal_at = solver->journal.now();
+
     runStats.clear();
     runStats.numCalls = 1;
     depth_warning_issued = false;
     const double my_time = cpuTime();
 
+    //Entries visited by the last run are reset at its end
     globalIndex = 0;
-    index.clear();
-    index.resize(solver->nVars()*2, numeric_limits<uint32_t>::max());
-    lowlink.clear();
-    lowlink.resize(solver->nVars()*2, numeric_limits<uint32_t>::max());
-    stackIndicator.clear();
-    stackIndicator.resize(solver->nVars()*2, false);
+    if (index.size() != solver->nVars()*2) {
+        index.clear();
+        index.resize(solver->nVars()*2, numeric_limits<uint32_t>::max());
+        lowlink.clear();
+        lowlink.resize(solver->nVars()*2, numeric_limits<uint32_t>::max());
+        stackIndicator.clear();
+        stackIndicator.resize(solver->nVars()*2, false);
+    }
     assert(stack.empty());
+    assert(visited.empty());
 
     depth = 0;
-    for (uint32_t vertex = 0; vertex < solver->nVars()*2; vertex++) {
+    const uint32_t num_start = incremental ? roots.size() : solver->nVars()*2;
+    for (uint32_t i = 0; i < num_start; i++) {
         //Start a DFS at each node we haven't visited yet
+        const uint32_t vertex = incremental ? (~roots[i]).toInt() : i;
         const uint32_t v = vertex>>1;
         if (solver->value(v) != l_Undef) {
             continue;
@@ -71,10 +92,17 @@ bool SCCFinder::performSCC(uint64_t* bogoprops_given)
             assert(stack.empty());
         }
     }
+    for(const uint32_t vertex: visited) {
+        index[vertex] = numeric_limits<uint32_t>::max();
+        lowlink[vertex] = numeric_limits<uint32_t>::max();
+    }
+    visited.clear();
 
     //Update & print stats
     runStats.cpu_time = cpuTime() - my_time;
     runStats.foundXorsNew = binxors.size();
+    runStats.incremental = incremental;
+    last_run_complete = !depth_warning_issued;
     if (solver->conf.verbosity) {
         if (solver->conf.verbosity >= 3)
             runStats.print();
@@ -107,6 +135,7 @@ void SCCFinder::tarjan(const uint32_t vertex)
     }
 
     runStats.bogoprops += 1;
+    visited.push_back(vertex);
     index[vertex] = globalIndex;  // Set the depth index for v
     lowlink[vertex] = globalIndex;
     globalIndex++;
@@ -177,6 +206,7 @@ void SCCFinder::Stats::print_short(Solver* solver) const
     cout
     << "c [scc]"
     << " new: " << foundXorsNew
+    << " incr: " << incremental
     << " BP " << bogoprops/(1000*1000) << "M";
     if (solver) {
         cout << solver->conf.print_times(cpu_time);
@@ -202,6 +232,8 @@ size_t SCCFinder::mem_used() const
     mem += stack.size()*sizeof(uint32_t); //TODO under-estimates
     mem += stackIndicator.capacity()*sizeof(char);
     mem += tmp.capacity()*sizeof(uint32_t);
+    mem += roots.capacity()*sizeof(Lit);
+    mem += visited.capacity()*sizeof(uint32_t);
 
     return mem;
 }
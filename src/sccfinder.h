@@ -38,6 +38,7 @@ class SCCFinder {
         const std::set<BinaryXor>& get_binxors() const;
         size_t get_num_binxors_found() const;
         void clear_binxors();
+        void discard_binxors();
 
         struct Stats
         {
@@ -52,10 +53,12 @@ class SCCFinder {
             uint64_t foundXors = 0;
             uint64_t foundXorsNew = 0;
             uint64_t bogoprops = 0;
+            uint64_t incremental = 0;
 
             Stats& operator+=(const Stats& other)
             {
                 numCalls += other.numCalls;
+                incremental += other.incremental;
                 cpu_time += other.cpu_time;
                 foundXors += other.foundXors;
                 foundXorsNew += other.foundXorsNew;
@@ -79,6 +82,12 @@ class SCCFinder {
                     , "new found per call"
                 );
 
+                print_stats_line("c incremental"
+                    , incremental
+                    , stats_line_percent(incremental, numCalls)
+                    , "% of calls"
+                );
+
                 print_stats_line("c found"
                     , foundXorsNew
                     , stats_line_percent(foundXorsNew, foundXors)
@@ -103,6 +112,12 @@ class SCCFinder {
     private:
         void tarjan(const uint32_t vertex);
         bool depth_warning_issued;
+
+        //Incremental runs, see conf.inprocess_incremental
+        uint64_t journal_at = 0;
+        bool last_run_complete = false;
+        vector<Lit> roots;
+        vector<uint32_t> visited;
         void doit(const Lit lit, const uint32_t vertex);
         void add_bin_xor_in_tmp();
 
@@ -159,6 +174,13 @@ inline void SCCFinder::clear_binxors()
     binxors.clear();
 }
 
+//They were not used, so the next run must find them again
+inline void SCCFinder::discard_binxors()
+{
+    binxors.clear();
+    last_run_complete = false;
+}
+
 } //end namespaceC
 
 #endif //SCCFINDER_H
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "propbyforgraph.h"
 #include <algorithm>
 #include <sstream>
+#include <stdexcept>
 #include <cstddef>
 #include <cmath>
 #include <ratio>
@@ -95,7 +96,33 @@ Searcher::Searcher(const SolverConf *_conf, Solver* _solver, std::atomic<bool>*
     next_sls = 44000.0*conf.global_next_multiplier;
 }
 
-Searcher::~Searcher() { clear_gauss_matrices(true); }
+Searcher::~Searcher() {
+    clear_gauss_matrices(true);
+    finish_restart_phase_span();
+    delete trace;
+}
+
+void Searcher::set_tracer(Tracer* tracer)
+{
+    delete trace;
+    trace = tracer ? new TraceBuffer(tracer, conf.thread_num) : nullptr;
+}
+
+// Restart phases (e.g. a run of luby restarts) show up as spans, individual
+// restarts would be too many for a long run
+void Searcher::start_restart_phase_span()
+{
+    if (!trace || !restart_phase_name.empty()) return;
+    restart_phase_name = "restart-" + restart_type_to_string(params.rest_type);
+    restart_phase_start_us = trace->now_us();
+}
+
+void Searcher::finish_restart_phase_span()
+{
+    if (!trace || restart_phase_name.empty()) return;
+    trace->span(restart_phase_name.c_str(), restart_phase_start_us, trace->now_us());
+    restart_phase_name.clear();
+}
 
 void Searcher::new_var(
     const bool bva,
@@ -276,8 +303,9 @@ void Searcher::normalClMinim()
                 break;
             }
 
-            case bnn_t: {
-                auto bnn_reason = get_bnn_reason(bnns[reason.getBNNidx()], learnt_clause[i]);
+            case bnn_t:
+            case ext_t: {
+                auto bnn_reason = get_lazy_reason(reason, learnt_clause[i]);
                 lits = bnn_reason->data();
                 size = bnn_reason->size()-1;
                 sumAntecedentsLits += size;
@@ -292,6 +320,7 @@ void Searcher::normalClMinim()
             switch (type) {
                 case xor_t:
                 case bnn_t:
+                case ext_t:
                 case clause_t:
                     p = lits[k+1];
                     break;
@@ -477,8 +506,9 @@ void Searcher::add_lits_to_learnt(
             break;
         }
 
-        case bnn_t: {
-            auto bnn_reason = get_bnn_reason(bnns[confl.getBNNidx()], p);
+        case bnn_t:
+        case ext_t: {
+            auto bnn_reason = get_lazy_reason(confl, p);
             lits = bnn_reason->data();
             size = bnn_reason->size();
             sumAntecedentsLits += size;
@@ -508,6 +538,7 @@ void Searcher::add_lits_to_learnt(
                 break;
 
             case bnn_t:
+            case ext_t:
             case clause_t:
             case xor_t:
                 x = lits[i];
@@ -634,7 +665,7 @@ void Searcher::create_learnt_clause(PropBy confl)
             break;
         }
         case bnn_t : {
-            auto cl = get_bnn_reason(bnns[confl.getBNNidx()], lit_Undef);
+            auto cl = get_lazy_reason(confl, lit_Undef);
             lit0 = (*cl)[0];
             break;
         }
@@ -704,6 +735,7 @@ void Searcher::simple_create_learnt_clause(
             }
 
             case bnn_t:
+            case ext_t:
             case xor_t:
             case clause_t: {
                 Lit* lits;
@@ -712,8 +744,8 @@ void Searcher::simple_create_learnt_clause(
                     auto cl = solver->cl_alloc.ptr(confl.get_offset());
                     lits = cl->getData();
                     size = cl->size();
-                } else if (confl.getType() == bnn_t) {
-                    auto cl = get_bnn_reason(bnns[confl.getBNNidx()], p);
+                } else if (confl.getType() == bnn_t || confl.getType() == ext_t) {
+                    auto cl = get_lazy_reason(confl, p);
                     lits = cl->data();
                     size = cl->size();
                 } else {
@@ -949,8 +981,9 @@ bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
                 break;
             }
 
-            case bnn_t: {
-                vector<Lit>* cl = get_bnn_reason(bnns[reason.getBNNidx()],
+            case bnn_t:
+            case ext_t: {
+                vector<Lit>* cl = get_lazy_reason(reason,
                     Lit(p_analyze.var(), value(p_analyze.var()) == l_False));
                 lits = cl->data();
                 size = cl->size()-1;
@@ -974,6 +1007,7 @@ bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
             switch (type) {
                 case xor_t:
                 case bnn_t:
+                case ext_t:
                 case clause_t:
                     p2 = lits[i+1];
                     break;
@@ -1089,8 +1123,9 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
                         break;
                     }
 
-                    case bnn_t : {
-                        vector<Lit>* cl = get_bnn_reason(bnns[reason.getBNNidx()], lit_Undef);
+                    case bnn_t :
+                    case ext_t : {
+                        vector<Lit>* cl = get_lazy_reason(reason, trail[i].lit);
                         for(const Lit lit: *cl) {
                             if (varData[lit.var()].level > 0)seen[lit.var()] = 1;
                         }
@@ -1265,7 +1300,18 @@ lbool Searcher::search()
             search_ret = l_False;
             goto end;
         }
-        if (confl.isnullptr()) confl = propagate<false>();
+        if (confl.isnullptr()) {
+            // With hardware counters on, every 64th call is measured. A read
+            // is a system call, far too slow to do on every call
+            if (hw.enabled() && (++hw_prop_calls & 63) == 0) {
+                const HwCounts before = hw.read();
+                confl = propagate<false>();
+                telemetry.add_hw("propagate-sampled", before, hw.read());
+            } else confl = propagate<false>();
+        }
+        if (confl.isnullptr() && ext_prop && ext_propagate(confl) && confl.isnullptr()) {
+            continue;
+        }
         if (!confl.isnullptr()) {
             #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
             hist.trailDepthHist.push(trail.size());
@@ -1292,6 +1338,7 @@ lbool Searcher::search()
             lbool dec_ret;
             if (fast_backw.fast_backw_on) dec_ret = new_decision_fast_backw();
             else dec_ret = new_decision<false>();
+            if (dec_ret == l_True && ext_prop && !ext_check_model()) continue;
             if (dec_ret != l_Undef) {
                 search_ret = dec_ret;
                 goto end;
@@ -1315,6 +1362,7 @@ lbool Searcher::search()
     SLOW_DEBUG_DO(assert(check_order_heap_sanity()));
 
     end:
+    flush_learnt_export();
     print_restart_stat();
     dump_search_loop_stats(my_time);
     return search_ret;
@@ -1349,6 +1397,7 @@ lbool Searcher::new_decision() {
 
         if (value(p) == l_True) {
             // Dummy decision level:
+            if (!inprocess && ext_prop) ext_prop->notify_new_decision_level();
             new_decision_level();
         } else if (value(p) == l_False) {
             analyze_final_confl_with_assumptions(~p, conflict);
@@ -1376,6 +1425,7 @@ lbool Searcher::new_decision() {
 
     // Increase decision level and enqueue 'next'
     assert(value(next) == l_Undef);
+    if (!inprocess && ext_prop) ext_prop->notify_new_decision_level();
     new_decision_level();
     enqueue<inprocess>(next);
 
@@ -1430,6 +1480,9 @@ void Searcher::attach_and_enqueue_learnt_clause(
     const uint64_t ID)
 {
     VERBOSE_DEBUG_DO(print_learning_debug_info(ID));
+    if (learnt_export.learn && learnt_clause.size() <= learnt_export.max_len) {
+        export_learnt_clause();
+    }
     switch (learnt_clause.size()) {
         case 0: release_assert(false);
         case 1:
@@ -1477,6 +1530,300 @@ void Searcher::attach_and_enqueue_learnt_clause(
     }
 }
 
+void Searcher::export_learnt_clause()
+{
+    //Translation is postponed to the flush, it's cheaper in bulk
+    for(const Lit l: learnt_clause) learnt_export_buf.push_back(l);
+    learnt_export_buf.push_back(lit_Undef);
+    if (learnt_export_buf.size() >= 64*1024) flush_learnt_export();
+}
+
+// Must be called before the variables are renumbered, as the buffer is
+// kept in the internal numbering
+void Searcher::flush_learnt_export()
+{
+    if (learnt_export_buf.empty()) return;
+    assert(learnt_export.learn);
+
+    size_t j = 0;
+    size_t cl_start = 0;
+    bool skip = false;
+    for(size_t i = 0; i < learnt_export_buf.size(); i++) {
+        const Lit l = learnt_export_buf[i];
+        if (l == lit_Undef) {
+            if (skip) j = cl_start;
+            else learnt_export_buf[j++] = lit_Undef;
+            cl_start = j;
+            skip = false;
+            continue;
+        }
+        //BVA and BreakID variables are invisible from the outside
+        if (varData[l.var()].is_bva) skip = true;
+        learnt_export_buf[j++] = map_inter_to_outer(l);
+    }
+    learnt_export_buf.resize(j);
+
+    if (!learnt_export_buf.empty()) {
+        learnt_export.learn(learnt_export.state, learnt_export_buf);
+    }
+    learnt_export_buf.clear();
+}
+
+// Replacement and renumbering may have happened since the last call, so the
+// observed variables are looked up again
+// Misuse of the propagator API is reported to the caller, the same way as
+// in connect_propagator()
+void Searcher::ext_misuse(const char* what) const
+{
+    const std::string err = std::string("ERROR: external propagator: ") + what;
+    std::cerr << err << endl;
+    throw std::runtime_error(err);
+}
+
+void Searcher::ext_setup()
+{
+    assert(decisionLevel() == 0);
+    ext_obs_of.clear();
+    ext_obs_of.resize(nVars());
+    ext_prop_lit.resize(nVars());
+    for(const uint32_t outer: ext_observed) {
+        Lit l = solver->varReplacer->get_lit_replaced_with_outer(Lit(outer, false));
+        l = map_outer_to_inter(l);
+        assert(l.var() < nVars() && "renumbering keeps observed variables");
+        assert(varData[l.var()].removed == Removed::none);
+        assert(varData[l.var()].observed);
+        ext_obs_of[l.var()].push_back(Lit(outer, l.sign()));
+    }
+
+    //After renumbering, the trail only has its length right, so the level 0
+    //assignments are reported from the values
+    ext_notify_buf.clear();
+    for(uint32_t v = 0; v < ext_obs_of.size(); v++) {
+        if (value(v) == l_Undef) continue;
+        for(const Lit ob: ext_obs_of[v]) ext_notify_buf.push_back(ob ^ (value(v) == l_False));
+    }
+    if (!ext_notify_buf.empty()) ext_prop->notify_assignment(ext_notify_buf);
+    ext_notified = trail.size();
+    ext_need_clause = false;
+}
+
+void Searcher::ext_notify_assignments()
+{
+    ext_notify_buf.clear();
+    for(; ext_notified < trail.size(); ext_notified++) {
+        const Lit l = trail[ext_notified].lit;
+        if (l == lit_Undef) continue;
+        for(const Lit ob: ext_obs_of[l.var()]) ext_notify_buf.push_back(ob ^ l.sign());
+    }
+    if (!ext_notify_buf.empty()) ext_prop->notify_assignment(ext_notify_buf);
+}
+
+// Returns TRUE if the trail changed, in which case "confl" may be set
+// or the solver may have become UNSAT
+bool Searcher::ext_propagate(PropBy& confl)
+{
+    ext_notify_assignments();
+
+    ext_user_cl.clear();
+    bool forgettable = false;
+    while(ext_prop->has_external_clause(ext_user_cl, forgettable)) {
+        ext_need_clause = false;
+        if (ext_add_clause(ext_user_cl, forgettable, confl)) return true;
+        ext_user_cl.clear();
+        forgettable = false;
+    }
+    if (ext_need_clause) ext_misuse("the propagator rejected the model but gave no clause");
+
+    while(true) {
+        const Lit p = ext_prop->propagate();
+        if (p == lit_Undef) return false;
+        if (p.var() >= nVarsOuter()) ext_misuse("propagated literal has unknown variable");
+
+        Lit l = solver->varReplacer->get_lit_replaced_with_outer(p);
+        l = map_outer_to_inter(l);
+        if (!varData[l.var()].observed) ext_misuse("propagated literal is not observed");
+        if (value(l) == l_True) continue;
+        if (value(l) == l_Undef) {
+            //The reason is only asked for if conflict analysis needs it
+            ext_prop_lit[l.var()] = p;
+            enqueue<false>(l, decisionLevel(), PropBy(ext_t));
+            return true;
+        }
+
+        //The reason clause is conflicting, so it is needed straight away
+        ext_user_cl.clear();
+        ext_prop->add_reason_clause(p, ext_user_cl);
+        if (std::find(ext_user_cl.begin(), ext_user_cl.end(), p) == ext_user_cl.end())
+            ext_misuse("reason clause must contain the propagated literal");
+        if (ext_add_clause(ext_user_cl, true, confl)) return true;
+    }
+}
+
+vector<Lit>* Searcher::get_lazy_reason(const PropBy& reason, const Lit lit)
+{
+    if (reason.isBNN()) return get_bnn_reason(bnns[reason.getBNNidx()], lit);
+
+    //Kept in a slot until "lit" is unassigned
+    assert(reason.isExt());
+    assert(lit != lit_Undef && "the propagator never gives a conflict this way");
+    PropBy& r = varData[lit.var()].reason;
+    if (r.ext_reason_set()) return &ext_reasons[r.get_ext_reason()];
+    uint32_t slot;
+    if (ext_reasons_empty_slots.empty()) {
+        slot = ext_reasons.size();
+        ext_reasons.push_back(vector<Lit>());
+    } else {
+        slot = ext_reasons_empty_slots.back();
+        ext_reasons_empty_slots.pop_back();
+    }
+    r.set_ext_reason(slot);
+    ext_get_reason(lit, ext_reasons[slot]);
+    return &ext_reasons[slot];
+}
+
+// Asks the propagator for the reason of "p". The propagated literal goes
+// first, as for every other reason
+void Searcher::ext_get_reason(const Lit p, vector<Lit>& out)
+{
+    const Lit outer = ext_prop_lit[p.var()];
+    assert(value(p) == l_True);
+
+    ext_user_cl.clear();
+    ext_prop->add_reason_clause(outer, ext_user_cl);
+    out.clear();
+    out.push_back(p);
+    bool found = false;
+    for(Lit l: ext_user_cl) {
+        if (l.var() >= nVarsOuter()) ext_misuse("reason clause contains unknown variable");
+        if (l == outer) {
+            found = true;
+            continue;
+        }
+        l = solver->varReplacer->get_lit_replaced_with_outer(l);
+        l = map_outer_to_inter(l);
+        if (l == p) continue;
+        if (value(l) != l_False || varData[l.var()].level > varData[p.var()].level)
+            ext_misuse("reason clause literals must be FALSE before the propagated literal");
+        out.push_back(l);
+    }
+    if (!found) ext_misuse("reason clause must contain the propagated literal");
+}
+
+// Adds a clause in the middle of search: an irredundant one, or a redundant
+// one that reduceDB may delete. Backtracks if the clause is unit or
+// conflicting at a level lower than the current one.
+// Returns TRUE if the trail changed
+bool Searcher::ext_add_clause(const vector<Lit>& lits, const bool red, PropBy& confl)
+{
+    ext_cl.clear();
+    for(Lit l: lits) {
+        if (l.var() >= nVarsOuter()) ext_misuse("external clause contains unknown variable");
+        l = solver->varReplacer->get_lit_replaced_with_outer(l);
+        l = map_outer_to_inter(l);
+        if (!varData[l.var()].observed) ext_misuse("external clause contains unobserved variable");
+        if (value(l) != l_Undef && varData[l.var()].level == 0) {
+            if (value(l) == l_True) return false;
+            continue;
+        }
+        ext_cl.push_back(l);
+    }
+
+    //Remove duplicates, skip tautologies
+    std::sort(ext_cl.begin(), ext_cl.end());
+    Lit prev = lit_Undef;
+    uint32_t j = 0;
+    for(uint32_t i = 0; i < ext_cl.size(); i++) {
+        if (ext_cl[i] == ~prev) return false;
+        if (ext_cl[i] != prev) ext_cl[j++] = prev = ext_cl[i];
+    }
+    ext_cl.resize(j);
+
+    if (ext_cl.empty()) {
+        ok = false;
+        return true;
+    }
+    if (ext_cl.size() == 1) {
+        cancelUntil(0);
+        enqueue<false>(ext_cl[0]);
+        return true;
+    }
+
+    //TRUE lowest level first, then UNDEF, then FALSE highest level first.
+    //This way the first two literals are correct to watch
+    auto rank = [&](const Lit l) {
+        return value(l) == l_True ? 0 : (value(l) == l_Undef ? 1 : 2);
+    };
+    std::sort(ext_cl.begin(), ext_cl.end(), [&](const Lit a, const Lit b) {
+        const int ra = rank(a);
+        const int rb = rank(b);
+        if (ra != rb) return ra < rb;
+        if (ra == 0) return varData[a.var()].level < varData[b.var()].level;
+        if (ra == 2) return varData[a.var()].level > varData[b.var()].level;
+        return false;
+    });
+
+    const int32_t ID = ++clauseID;
+    PropBy reason;
+    if (ext_cl.size() == 2) {
+        solver->attach_bin_clause(ext_cl[0], ext_cl[1], red, ID, false);
+        reason = PropBy(ext_cl[1], red, ID);
+    } else {
+        Clause* cl = cl_alloc.Clause_new(ext_cl, sumConflicts, ID);
+        cl->isRed = red;
+        const ClOffset offset = cl_alloc.get_offset(cl);
+        if (red) {
+            cl->stats.glue = std::min<uint32_t>(calc_glue(ext_cl), ext_cl.size());
+            cl->stats.which_red_array = 2;
+            #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+            red_stats_extra.push_back(ClauseStatsExtra());
+            cl->stats.extra_pos = red_stats_extra.size()-1;
+            red_stats_extra.back().introduced_at_conflict = sumConflicts;
+            red_stats_extra.back().orig_glue = cl->stats.glue;
+            red_stats_extra.back().orig_size = cl->size();
+            #endif
+            longRedCls[2].push_back(offset);
+        } else {
+            longIrredCls.push_back(offset);
+        }
+        solver->attachClause(*cl, false);
+        reason = PropBy(offset);
+    }
+
+    const Lit l0 = ext_cl[0];
+    const Lit l1 = ext_cl[1];
+    if (value(l1) != l_False) return false;
+
+    //All but l0 are FALSE
+    const uint32_t lev1 = varData[l1.var()].level;
+    if (value(l0) == l_False && varData[l0.var()].level == lev1) {
+        cancelUntil(lev1);
+        if (ext_cl.size() == 2) {
+            confl = PropBy(l0, false, ID);
+            failBinLit = l1;
+        } else {
+            confl = reason;
+        }
+        return true;
+    }
+    if (value(l0) == l_True && varData[l0.var()].level <= lev1) return false;
+
+    //Propagates, possibly at a lower level than the current
+    cancelUntil(lev1);
+    enqueue<false>(l0, decisionLevel(), reason);
+    return true;
+}
+
+bool Searcher::ext_check_model()
+{
+    ext_model.assign(nVarsOuter(), l_Undef);
+    for(uint32_t v = 0; v < ext_obs_of.size(); v++) {
+        for(const Lit ob: ext_obs_of[v]) ext_model[ob.var()] = value(v) ^ ob.sign();
+    }
+    if (ext_prop->check_found_model(ext_model)) return true;
+    ext_need_clause = true;
+    return false;
+}
+
 void Searcher::print_learning_debug_info(const int32_t ID) const
 {
     cout
@@ -1768,6 +2115,8 @@ bool Searcher::handle_conflict(PropBy confl)
     uint32_t glue;
     uint32_t glue_before_minim;
     uint32_t size_before_minim;
+    const bool hw_sample = hw.enabled() && (++hw_analyze_calls & 63) == 0;
+    const HwCounts hw_before = hw_sample ? hw.read() : HwCounts();
     analyze_conflict<false>(
         confl
         , backtrack_level  //return backtrack level here
@@ -1775,6 +2124,7 @@ bool Searcher::handle_conflict(PropBy confl)
         , glue_before_minim         //return glue before minimization here
         , size_before_minim         //return glue before minimization here
     );
+    if (hw_sample) telemetry.add_hw("analyze-sampled", hw_before, hw.read());
     solver->datasync->signal_new_long_clause(learnt_clause);
 
     uint32_t connects_num_communities = 0;
@@ -1810,6 +2160,7 @@ bool Searcher::handle_conflict(PropBy confl)
         && xorclauses.empty()
         && gmatrices.empty()
         && bnns.empty()
+        && !ext_prop //the propagator expects assignments ordered by level
         && (((int)decisionLevel() - (int)backtrack_level) >= conf.diff_declev_for_chrono)
     ) {
         chrono_backtrack++;
@@ -2094,25 +2445,36 @@ void Searcher::reduce_db_if_needed()
     }
     #endif
 
+    if (conf.mem_budget_bytes != 0 && sumConflicts >= next_mem_check) {
+        solver->check_mem_budget();
+        next_mem_check = sumConflicts + 5000;
+    }
+
     #ifndef FINAL_PREDICTOR
     if (conf.every_lev1_reduce != 0
         && sumConflicts >= next_lev1_reduce
     ) {
+        const PhaseSnapshot before = phase_snapshot();
         solver->reduceDB->handle_lev1();
         next_lev1_reduce = sumConflicts + conf.every_lev1_reduce;
+        telemetry.add("reducedb-lev1", before, phase_snapshot());
     }
 
     if (conf.every_lev2_reduce != 0) {
         if (sumConflicts >= next_lev2_reduce) {
+            const PhaseSnapshot before = phase_snapshot();
             solver->reduceDB->handle_lev2();
             cl_alloc.consolidate(solver);
             next_lev2_reduce = sumConflicts + conf.every_lev2_reduce;
+            telemetry.add("reducedb-lev2", before, phase_snapshot());
         }
     } else {
         if (longRedCls[2].size() > cur_max_temp_red_lev2_cls) {
+            const PhaseSnapshot before = phase_snapshot();
             solver->reduceDB->handle_lev2();
             cur_max_temp_red_lev2_cls *= conf.inc_max_temp_lev2_red_cls;
             cl_alloc.consolidate(solver);
+            telemetry.add("reducedb-lev2", before, phase_snapshot());
         }
     }
     #endif
@@ -2341,6 +2703,15 @@ bool Searcher::must_abort(const lbool status) {
         return true;
     }
 
+    if (solver->mem_budget_hit) {
+        if (conf.verbosity >= 3) {
+            cout
+            << "c search over memory budget"
+            << endl;
+        }
+        return true;
+    }
+
     return false;
 }
 
@@ -2507,6 +2878,7 @@ lbool Searcher::solve(const uint64_t _max_confls) {
 
     setup_branch_strategy();
     setup_restart_strategy(false);
+    start_restart_phase_span();
     setup_polarity_strategy();
     STATS_DO(check_calc_satzilla_features(true));
     #ifdef STATS_NEEDED_BRANCH
@@ -2514,6 +2886,7 @@ lbool Searcher::solve(const uint64_t _max_confls) {
     #endif
 
     SLOW_DEBUG_DO(assert(fast_backw.fast_backw_on || solver->check_order_heap_sanity()));
+    if (ext_prop) ext_setup();
     while(stats.conflicts < max_confl_per_search_solve_call && status == l_Undef) {
         if (!conf.never_stop_search &&
                 (distill_clauses_if_needed() == l_False
@@ -2546,6 +2919,7 @@ lbool Searcher::solve(const uint64_t _max_confls) {
     }
 
     end:
+    finish_restart_phase_span();
     finish_up_solve(status);
     return status;
 }
@@ -2608,6 +2982,9 @@ void Searcher::setup_restart_strategy(bool force)
         }
     }
 
+    finish_restart_phase_span();
+    start_restart_phase_span();
+
     verb_print(2, "[restart] adjusting strategy. "
     << " restart_strategy_change:" << restart_strategy_change
     << " restart_strategy_at: " << restart_strategy_at
@@ -3164,6 +3541,10 @@ void Searcher::cancelUntil(uint32_t blevel)
 
     if (decisionLevel() > blevel) {
         if (!inprocess) update_polarities_on_backtrack(blevel);
+        if (!inprocess && ext_prop) {
+            ext_notified = std::min(ext_notified, trail_lim[blevel]);
+            ext_prop->notify_backtrack(blevel);
+        }
 
         for (uint32_t i = 0; i < gmatrices.size(); i++)
             if (gmatrices[i] && !gqueuedata[i].disabled)
@@ -3185,6 +3566,12 @@ void Searcher::cancelUntil(uint32_t blevel)
                 bnn_reasons_empty_slots.push_back(reason_idx);
                 varData[var].reason = PropBy();
             }
+            if (varData[var].reason.isExt() &&
+                varData[var].reason.ext_reason_set())
+            {
+                ext_reasons_empty_slots.push_back(varData[var].reason.get_ext_reason());
+                varData[var].reason = PropBy();
+            }
             if (!bnns.empty()) reverse_prop(trail[i].lit);
 
             #ifdef STATS_NEEDED_BRANCH
@@ -3387,7 +3774,7 @@ ConflictData Searcher::find_conflict_level(PropBy& pb) {
             }
 
             case PropByType::bnn_t: {
-                auto cl = get_bnn_reason(bnns[pb.getBNNidx()], lit_Undef);
+                auto cl = get_lazy_reason(pb, lit_Undef);
                 lits = cl->data();
                 size = cl->size();
                 break;
@@ -3511,6 +3898,7 @@ bool Searcher::clear_gauss_matrices(const bool destruct) {
         auto gqd = gqueuedata[i];
         verb_print(2, "[mat" << i << "] num_props       : " << print_value_kilo_mega(gqd.num_props));
         verb_print(2, "[mat" << i << "] num_conflicts   : " << print_value_kilo_mega(gqd.num_conflicts));
+        add_gauss_stats(telemetry, i, gqd);
     }
 
     if (conf.verbosity) print_matrix_stats();
@@ -3527,6 +3915,45 @@ bool Searcher::clear_gauss_matrices(const bool destruct) {
     return okay();
 }
 
+PhaseSnapshot Searcher::phase_snapshot() const
+{
+    double vm_usage;
+    PhaseSnapshot snap;
+    snap.wall_time = real_time_sec();
+    snap.cpu_time = cpuTime();
+    snap.propagations = solver->sumPropStats.propagations + propStats.propagations;
+    snap.conflicts = sumConflicts;
+    snap.mem = memUsedTotal(vm_usage);
+    snap.free_vars = solver->get_num_free_vars();
+    snap.lits = litStats.irredLits + litStats.redLits + 2*(binTri.irredBins + binTri.redBins);
+    snap.hw = hw.read();
+    return snap;
+}
+
+// Propagations and conflicts of a matrix go to "gauss", and to the
+// "gauss-<i>" entry that timed its init
+void Searcher::add_gauss_stats(Telemetry& t, const uint32_t i, const GaussQData& gqd)
+{
+    PhaseStats& gauss_stats = t.get("gauss");
+    gauss_stats.calls++;
+    gauss_stats.propagations += gqd.num_props;
+    gauss_stats.conflicts += gqd.num_conflicts;
+    PhaseStats& mat_stats = t.get("gauss-" + std::to_string(i));
+    mat_stats.propagations += gqd.num_props;
+    mat_stats.conflicts += gqd.num_conflicts;
+}
+
+// The matrices that are still live are counted too
+vector<PhaseStats> Searcher::get_phase_stats() const
+{
+    Telemetry t = telemetry;
+    for(uint32_t i = 0; i < gqueuedata.size(); i++) add_gauss_stats(t, i, gqueuedata[i]);
+    vector<PhaseStats> ret = t.get_phases();
+    ret.erase(std::remove_if(ret.begin(), ret.end(),
+        [](const PhaseStats& p) { return p.calls == 0; }), ret.end());
+    return ret;
+}
+
 void Searcher::print_matrix_stats() {
     for(EGaussian* g: gmatrices) if (g) g->print_matrix_stats(conf.verbosity);
 }
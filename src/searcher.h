@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "hyperengine.h"
 #include "searchstats.h"
 #include "searchhist.h"
+#include "telemetry.h"
+#include "tracer.h"
 
 #ifdef CMS_TESTING_ENABLED
 #include "gtest/gtest_prod.h"
@@ -82,6 +84,14 @@ class Searcher : public HyperEngine
         void set_seed(const uint32_t seed);
 
 
+        //Learnt clause export
+        LearntExport learnt_export;
+        void flush_learnt_export();
+
+        //External propagator
+        ExternalPropagator* ext_prop = nullptr;
+        vector<uint32_t> ext_observed; ///<Outer variables
+
         vector<lbool>  model;
         vector<Lit>   conflict;     ///<If problem is unsatisfiable (possibly under assumptions), this vector represent the final conflict clause expressed in the assumptions.
         template<bool inprocess, bool red_also = true, bool distill_use = false>
@@ -132,6 +142,23 @@ class Searcher : public HyperEngine
         uint32_t non_chrono_backtrack = 0;
         void consolidate_watches(const bool full);
 
+        //Per-phase telemetry, see telemetry.h
+        Telemetry telemetry;
+        //Hardware counters, open only if conf.hw_counters is set
+        HwCounters hw;
+        uint32_t hw_prop_calls = 0; ///<Every 64th propagate() in search is sampled
+        uint32_t hw_analyze_calls = 0; ///<Every 64th conflict analysis is sampled
+        //Timeline, nullptr unless tracing is on, see tracer.h
+        TraceBuffer* trace = nullptr;
+        void set_tracer(Tracer* tracer);
+        void start_restart_phase_span();
+        void finish_restart_phase_span();
+        std::string restart_phase_name;
+        uint64_t restart_phase_start_us = 0;
+        PhaseSnapshot phase_snapshot() const;
+        vector<PhaseStats> get_phase_stats() const;
+        static void add_gauss_stats(Telemetry& t, uint32_t i, const GaussQData& gqd);
+
         //Gauss
         bool attach_xorclauses();
         bool clear_gauss_matrices(const bool destruct);
@@ -289,6 +316,28 @@ class Searcher : public HyperEngine
             const bool enqueue,
             const uint64_t ID);
         void  print_learning_debug_info(const int32_t ID) const;
+        vector<Lit> learnt_export_buf; ///<Internal numbering, lit_Undef-terminated
+        void  export_learnt_clause();
+
+        //External propagator
+        vector<vector<Lit>> ext_obs_of; ///<Inter var -> observed outer lits equivalent to it
+        vector<Lit> ext_notify_buf;
+        vector<Lit> ext_user_cl; ///<Outer numbering
+        vector<Lit> ext_cl;
+        vector<lbool> ext_model;
+        vector<Lit> ext_prop_lit; ///<Inter var -> outer lit the propagator propagated
+        uint32_t ext_notified = 0; ///<Position in trail up to which the propagator was notified
+        bool ext_need_clause = false;
+        vector<vector<Lit>> ext_reasons; ///<Reasons asked for, kept until the literal is unassigned
+        vector<uint32_t> ext_reasons_empty_slots;
+        void ext_setup();
+        void ext_misuse(const char* what) const;
+        void ext_notify_assignments();
+        bool ext_propagate(PropBy& confl);
+        bool ext_add_clause(const vector<Lit>& lits, bool red, PropBy& confl);
+        void ext_get_reason(Lit p, vector<Lit>& out);
+        bool ext_check_model();
+        vector<Lit>* get_lazy_reason(const PropBy& reason, Lit lit);
         template<bool inprocess>
         void add_lits_to_learnt(const PropBy confl, const Lit p, uint32_t nDecisionLevel);
         template<bool inprocess>
@@ -336,6 +385,7 @@ class Searcher : public HyperEngine
         uint64_t next_lev1_reduce;
         uint64_t next_lev2_reduce;
         uint64_t next_pred_reduce;
+        uint64_t next_mem_check = 0;
 
         ///////////////
         // Restart parameters
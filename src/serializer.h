@@ -0,0 +1,178 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <type_traits>
+
+namespace CMSat {
+
+// Minimal binary archives for the solver's own state. The layout is the
+// in-memory layout of the host, so the data is only meant to be read back
+// by the same build on the same machine (e.g. an on-disk cache). Use
+// with "ar << x" and "ar >> x", like boost archives.
+class OutArchive {
+public:
+    template<class T>
+    OutArchive& operator<<(const T& v) { put(v); return *this; }
+
+    const std::string& str() const { return data; }
+
+private:
+    template<class T>
+    typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+    put(const T& v) {
+        data.append((const char*)&v, sizeof(T));
+    }
+
+    void put(const std::string& s) {
+        put((uint64_t)s.size());
+        data.append(s);
+    }
+
+    void put(const std::vector<bool>& v) {
+        put((uint64_t)v.size());
+        for(const bool b: v) put((uint8_t)b);
+    }
+
+    template<class T>
+    void put(const std::vector<T>& v) {
+        put((uint64_t)v.size());
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            data.append((const char*)v.data(), v.size()*sizeof(T));
+        } else {
+            for(const auto& x: v) put(x);
+        }
+    }
+
+    template<class K, class V>
+    void put(const std::map<K, V>& m) {
+        put((uint64_t)m.size());
+        for(const auto& x: m) {
+            put(x.first);
+            put(x.second);
+        }
+    }
+
+    std::string data;
+};
+
+// Reading past the end, or an absurd size, sets failed() and leaves the
+// remaining values default-constructed instead of crashing on corrupt input
+class InArchive {
+public:
+    InArchive(const char* _data, size_t _size) : data(_data), size(_size) {}
+    explicit InArchive(const std::string& s) : data(s.data()), size(s.size()) {}
+
+    template<class T>
+    InArchive& operator>>(T& v) { get(v); return *this; }
+
+    bool failed() const { return bad; }
+    bool at_end() const { return at == size; }
+
+private:
+    bool take(void* out, size_t num) {
+        if (bad || size - at < num) {
+            bad = true;
+            return false;
+        }
+        memcpy(out, data + at, num);
+        at += num;
+        return true;
+    }
+
+    bool get_size(uint64_t& num, size_t min_elem_size) {
+        num = 0;
+        get(num);
+        if (min_elem_size > 0 && num > (size - at)/min_elem_size) {
+            bad = true;
+            num = 0;
+        }
+        return !bad;
+    }
+
+    template<class T>
+    typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+    get(T& v) {
+        if (!take(&v, sizeof(T))) v = T();
+    }
+
+    void get(std::string& s) {
+        uint64_t num;
+        s.clear();
+        if (!get_size(num, 1)) return;
+        s.assign(data + at, num);
+        at += num;
+    }
+
+    void get(std::vector<bool>& v) {
+        uint64_t num;
+        v.clear();
+        if (!get_size(num, 1)) return;
+        v.resize(num);
+        for(uint64_t i = 0; i < num; i++) {
+            uint8_t b = 0;
+            get(b);
+            v[i] = b;
+        }
+    }
+
+    template<class T>
+    void get(std::vector<T>& v) {
+        uint64_t num;
+        v.clear();
+        constexpr size_t min_elem = std::is_trivially_copyable<T>::value ? sizeof(T) : 1;
+        if (!get_size(num, min_elem)) return;
+        v.resize(num);
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            take((void*)v.data(), num*sizeof(T));
+        } else {
+            for(auto& x: v) get(x);
+        }
+    }
+
+    template<class K, class V>
+    void get(std::map<K, V>& m) {
+        uint64_t num;
+        m.clear();
+        if (!get_size(num, 1)) return;
+        for(uint64_t i = 0; i < num && !bad; i++) {
+            K k;
+            V val;
+            get(k);
+            get(val);
+            m[k] = std::move(val);
+        }
+    }
+
+    const char* data;
+    size_t size;
+    size_t at = 0;
+    bool bad = false;
+};
+
+}
@@ -75,6 +75,7 @@ THE SOFTWARE.
 #include "lucky.h"
 #include "get_clause_query.h"
 #include "community_finder.h"
+#include "serializer.h"
 extern "C" {
 #include "mpicosat/mpicosat.h"
 }
@@ -638,6 +639,7 @@ void Solver::attach_bin_clause(
     //Update stats
     if (red) binTri.redBins++;
     else binTri.irredBins++;
+    journal.touch_bin(lit1, lit2);
 
     //Call Solver's function for heavy-lifting
     PropEngine::attach_bin_clause(lit1, lit2, red, ID, checkUnassignedFirst);
@@ -795,7 +797,7 @@ void Solver::test_renumbering() const
         /* cout << "val[" << i << "]: " << value(i); */
         if (varData[i].removed == Removed::elimed
             || varData[i].removed == Removed::replaced
-            || value(i) != l_Undef
+            || (value(i) != l_Undef && !varData[i].observed)
         ) {
             uninteresting_seen = true;
             /* cout << " set/removed" << endl; */
@@ -803,7 +805,7 @@ void Solver::test_renumbering() const
             /* cout << " non-removed" << endl; */
         }
 
-        if (value(i) == l_Undef
+        if ((value(i) == l_Undef || varData[i].observed)
             && varData[i].removed != Removed::elimed
             && varData[i].removed != Removed::replaced
             && uninteresting_seen
@@ -864,9 +866,11 @@ size_t Solver::calculate_inter_to_outer_and_outer_to_inter(
         }
     }
 
+    //Observed variables stay effective even when set, so the external
+    //propagator can be told their values after save_on_var_memory()
     size_t num_effective_vars = 0;
     for(size_t i = 0; i < nVars(); i++) {
-        if (value(i) != l_Undef
+        if ((value(i) != l_Undef && !varData[i].observed)
             || varData[i].removed == Removed::elimed
             || varData[i].removed == Removed::replaced
         ) {
@@ -876,6 +880,7 @@ size_t Solver::calculate_inter_to_outer_and_outer_to_inter(
         }
     }
     assert(at == num_effective_vars);
+    if (conf.renumber_order != 0) order_vars_for_locality(fin, num_effective_vars);
     for(size_t i = 0; i < nVars(); i++) if (fin[i] == none) fin[i] = at++;
 
 
@@ -893,11 +898,78 @@ size_t Solver::calculate_inter_to_outer_and_outer_to_inter(
     return num_effective_vars;
 }
 
+//Renumbers the effective variables in the order of a BFS over the clause
+//graph, seeded in the compact order, so that variables sharing clauses end
+//up close in varData, assigns, watches and the heaps. With Louvain, the
+//communities are numbered one after the other, each in BFS order.
+void Solver::order_vars_for_locality(vector<uint32_t>& fin, const uint32_t num_effective)
+{
+    //Long irredundant clauses of every variable
+    vector<uint32_t> start(nVars()+1, 0);
+    for(const auto& off: longIrredCls) {
+        for(const Lit l: *cl_alloc.ptr(off)) start[l.var()+1]++;
+    }
+    for(uint32_t v = 0; v < nVars(); v++) start[v+1] += start[v];
+    vector<uint32_t> occ(start[nVars()]);
+    vector<uint32_t> fill(start.begin(), start.end()-1);
+    for(uint32_t i = 0; i < longIrredCls.size(); i++) {
+        for(const Lit l: *cl_alloc.ptr(longIrredCls[i])) occ[fill[l.var()]++] = i;
+    }
+
+    vector<uint32_t> by_fin(num_effective);
+    for(uint32_t v = 0; v < nVars(); v++) if (fin[v] < num_effective) by_fin[fin[v]] = v;
+
+    vector<uint32_t> order;
+    order.reserve(num_effective);
+    vector<char> in_order(nVars(), 0);
+    vector<char> cl_done(longIrredCls.size(), 0);
+    const auto visit = [&](const uint32_t v) {
+        if (in_order[v] || fin[v] >= num_effective) return;
+        in_order[v] = 1;
+        order.push_back(v);
+    };
+    for(const uint32_t seed: by_fin) {
+        if (in_order[seed]) continue;
+        size_t bfs_head = order.size();
+        visit(seed);
+        for(; bfs_head < order.size(); bfs_head++) {
+            const uint32_t v = order[bfs_head];
+            for(uint32_t sign = 0; sign < 2; sign++) {
+                for(const auto& w: watches[Lit(v, sign)]) {
+                    if (w.isBin() && !w.red()) visit(w.lit2().var());
+                }
+            }
+            //A clause is expanded only once, all its variables are then in
+            for(uint32_t k = start[v]; k < start[v+1]; k++) {
+                if (cl_done[occ[k]]) continue;
+                cl_done[occ[k]] = 1;
+                for(const Lit l: *cl_alloc.ptr(longIrredCls[occ[k]])) visit(l.var());
+            }
+        }
+    }
+    assert(order.size() == num_effective);
+
+    #ifdef STATS_NEEDED
+    if (conf.renumber_order == 2) {
+        CommunityFinder comm_finder(this);
+        comm_finder.compute();
+        //Communities in the order BFS first reached them
+        std::unordered_map<uint32_t, uint32_t> rank;
+        for(const uint32_t v: order) rank.emplace(varData[v].community_num, rank.size());
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return rank[varData[a].community_num] < rank[varData[b].community_num];
+        });
+    }
+    #endif
+
+    for(uint32_t i = 0; i < order.size(); i++) fin[order[i]] = i;
+}
+
 double Solver::calc_renumber_saving()
 {
     uint32_t num_used = 0;
     for(size_t i = 0; i < nVars(); i++) {
-        if (value(i) != l_Undef
+        if ((value(i) != l_Undef && !varData[i].observed)
             || varData[i].removed == Removed::elimed
             || varData[i].removed == Removed::replaced
         ) {
@@ -917,7 +989,10 @@ bool Solver::renumber_variables(bool must_renumber)
     SLOW_DEBUG_DO(for(const auto& x: xorclauses) for(const auto& v: x) assert(v < nVars()));
 
     if (nVars() == 0) return okay();
-    if (!must_renumber && calc_renumber_saving() < 0.2) return okay();
+    if (!must_renumber
+        && calc_renumber_saving() < 0.2
+        && (conf.renumber_order == 0 || renumbered_for_locality)
+    ) return okay();
     if (!clear_gauss_matrices(false)) return false;
 
     double my_time = cpuTime();
@@ -928,6 +1003,7 @@ bool Solver::renumber_variables(bool must_renumber)
     vector<uint32_t> inter_to_outer(nVarsOuter());
 
     size_t numEffectiveVars = calculate_inter_to_outer_and_outer_to_inter(outer_to_inter, inter_to_outer);
+    if (conf.renumber_order != 0) renumbered_for_locality = true;
 
     //Create temporary outer_to_inter2
     vector<uint32_t> inter_to_outer2(nVarsOuter()*2);
@@ -937,6 +1013,7 @@ bool Solver::renumber_variables(bool must_renumber)
     }
 
     renumber_clauses(outer_to_inter);
+    journal.touch_all();
     CNF::update_vars(outer_to_inter, inter_to_outer, inter_to_outer2);
     PropEngine::updateVars(outer_to_inter, inter_to_outer);
     Searcher::updateVars(outer_to_inter, inter_to_outer);
@@ -955,6 +1032,7 @@ bool Solver::renumber_variables(bool must_renumber)
     if (conf.verbosity) {
         cout
         << "c [renumber]"
+        << " order: " << (conf.renumber_order == 0 ? "compact" : "locality")
         << conf.print_times(time_used)
         << endl;
     }
@@ -982,6 +1060,7 @@ void Solver::new_vars(size_t n)
 
     Searcher::new_vars(n);
     varReplacer->new_vars(n);
+    journal.new_vars(n);
 
     if (conf.perform_occur_based_simp) {
         occsimplifier->new_vars(n);
@@ -998,6 +1077,7 @@ void Solver::new_var(
     Searcher::new_var(bva, orig_outer, insert_varorder);
 
     varReplacer->new_var(orig_outer);
+    journal.new_vars(1);
 
     if (conf.perform_occur_based_simp) {
         occsimplifier->new_var(orig_outer);
@@ -1055,6 +1135,24 @@ void Solver::uneliminate_sampling_set() {
     add_clause_helper(tmp);
 }
 
+//Detaches and frees everything satisfied at level 0, along with the learnt
+//clauses that are satisfied by the same units
+bool Solver::remove_satisfied_clauses()
+{
+    assert(decisionLevel() == 0);
+    if (!okay()) return false;
+    return clauseCleaner->remove_and_clean_all();
+}
+
+bool Solver::add_observed_var(const uint32_t outer_var)
+{
+    vector<Lit> tmp{Lit(outer_var, false)};
+    if (!add_clause_helper(tmp)) return false; // unelimininates, maps to inter
+    varData[tmp[0].var()].observed = 1;
+    ext_observed.push_back(outer_var);
+    return okay();
+}
+
 void Solver::add_assumption(const Lit assump)
 {
     assert(varData[assump.var()].assumption == l_Undef);
@@ -1314,6 +1412,7 @@ lbool Solver::simplify_problem_outside(const string* strategy)
 
     conf.global_timeout_multiplier = conf.orig_global_timeout_multiplier;
     solveStats.num_simplify_this_solve_call = 0;
+    open_hw_counters();
     set_assumptions();
     uneliminate_sampling_set();
 
@@ -1362,6 +1461,7 @@ void Solver::reset_for_solving() {
 
     solveStats.num_solve_calls++;
     check_and_upd_config_parameters();
+    mem_budget_hit = false;
 
     //Reset parameters
     luby_loop_num = 0;
@@ -1377,6 +1477,7 @@ lbool Solver::solve_with_assumptions(
     if (frat->enabled()) frat->set_sqlstats_ptr(sqlStats);
     copy_assumptions(_assumptions);
     reset_for_solving();
+    open_hw_counters();
 
     //Check if adding the clauses caused UNSAT
     lbool status = l_Undef;
@@ -1611,7 +1712,9 @@ uint64_t Solver::calc_num_confl_to_do_this_iter(const size_t iteration_num) cons
 
 lbool Solver::iterate_until_solved() {
     lbool status = l_Undef;
-    size_t iteration_num = 0;
+    size_t iteration_num = resume_iteration_num;
+    resume_iteration_num = 0;
+    if (last_checkpoint_time == 0) last_checkpoint_time = real_time_sec();
 
     while (status == l_Undef
         && !must_interrupt_asap()
@@ -1624,11 +1727,16 @@ lbool Solver::iterate_until_solved() {
 
         const uint64_t num_confl = calc_num_confl_to_do_this_iter(iteration_num);
         if (num_confl == 0) break;
+        check_mem_budget();
+        if (mem_budget_hit) break;
         if (!find_and_init_all_matrices()) {
             status = l_False;
             goto end;
         }
+        const PhaseSnapshot before = phase_snapshot();
+        TraceSpan span(trace, "search");
         status = Searcher::solve(num_confl);
+        telemetry.add("search", before, phase_snapshot());
 
         //Check for effectiveness
         check_recursive_minimization_effectiveness(status);
@@ -1650,9 +1758,16 @@ lbool Solver::iterate_until_solved() {
             || must_interrupt_asap()
         ) break;
 
+        //The data may have shrunk since the search stopped
+        if (mem_budget_hit) {
+            check_mem_budget();
+            if (mem_budget_hit) break;
+        }
+
         if (conf.do_simplify_problem) {
             status = simplify_problem(false, conf.simplify_schedule_nonstartup);
         }
+        if (status == l_Undef) checkpoint_if_needed(iteration_num);
     }
 
     #ifdef STATS_NEEDED
@@ -1726,6 +1841,7 @@ lbool Solver::execute_inprocess_strategy(
     std::istringstream ss(strategy + ", ");
     std::string token;
     std::string occ_strategy_tokens;
+    check_mem_budget();
 
     while(std::getline(ss, token, ',')) {
         if (sumConflicts >= conf.max_confl
@@ -1749,11 +1865,20 @@ lbool Solver::execute_inprocess_strategy(
 
         token = trim(token);
         std::transform(token.begin(), token.end(), token.begin(), ::tolower);
+        if (mem_pressure && (token.substr(0,3) == "occ" || token == "sls")) {
+            verb_print(1, "[mem-budget] close to memory budget, skipping strategy token: " << token);
+            continue;
+        }
         if (!occ_strategy_tokens.empty() && token.substr(0,3) != "occ") {
-            if (conf.perform_occur_based_simp && bnns.empty() && occsimplifier) {
+            if (conf.perform_occur_based_simp && bnns.empty() && occsimplifier && !mem_pressure) {
                 occ_strategy_tokens = trim(occ_strategy_tokens);
                 verb_print(1, "Executing OCC strategy token(s): '" << occ_strategy_tokens);
+                // "occ" includes setup and teardown, the tokens are recorded
+                // individually by OccSimplifier too
+                const PhaseSnapshot before = phase_snapshot();
+                TraceSpan span(trace, "occ");
                 occsimplifier->simplify(startup, occ_strategy_tokens);
+                telemetry.add("occ", before, phase_snapshot());
             }
             occ_strategy_tokens.clear();
             if (sumConflicts >= conf.max_confl || cpuTime() > conf.maxTime
@@ -1767,6 +1892,8 @@ lbool Solver::execute_inprocess_strategy(
 
         if (token.substr(0,3) != "occ" && !token.empty())
             verb_print(1, "--> Executing strategy token: " << token);
+        const PhaseSnapshot before = phase_snapshot();
+        TraceSpan span(token.empty() || token.substr(0,3) == "occ" ? nullptr : trace, token);
 
         if (token == "scc-vrepl") {
             if (conf.doFindAndReplaceEqLits) {
@@ -1915,6 +2042,9 @@ lbool Solver::execute_inprocess_strategy(
             cout << "ERROR: strategy '" << token << "' not recognised!" << endl;
             exit(-1);
         }
+        if (!token.empty() && token.substr(0,3) != "occ") {
+            telemetry.add(token, before, phase_snapshot());
+        }
 
         SLOW_DEBUG_DO(check_stats());
         if (!okay()) return l_False;
@@ -1944,6 +2074,7 @@ lbool Solver::simplify_problem(const bool startup, const string& strategy) {
         return l_Undef;
     }
 
+    TraceSpan span(trace, "simplify");
     lbool ret = l_Undef;
     clear_order_heap();
     if (!clear_gauss_matrices(false)) return l_False;
@@ -2007,6 +2138,35 @@ void CMSat::Solver::print_stats(
     print_norm_stats(cpu_time, cpu_time_total, wallclock_time_started);
 }
 
+// Counters are per thread and every solve() call may run on a new thread
+void Solver::open_hw_counters()
+{
+    if (!conf.hw_counters || hw.open()) return;
+    //Asked for explicitly, so say it even when running quietly
+    cout << "c WARNING: could not open hardware performance counters"
+        << " (not Linux, no PMU or perf_event_paranoid too high), turning them off"
+        << endl;
+    conf.hw_counters = 0;
+}
+
+void Solver::print_hw_stats() const
+{
+    for(const PhaseStats& p: telemetry.get_phases()) {
+        if (p.instructions == 0) continue;
+        const double kinstr = (double)p.instructions/1000.0;
+        print_stats_line("c hw " + p.name
+            , float_div(p.instructions, p.cycles)
+            , "IPC"
+            , float_div(p.cache_misses, kinstr)
+            , "cache-miss/kinstr"
+        );
+        print_stats_line("c hw " + p.name + " br-miss"
+            , float_div(p.branch_misses, kinstr)
+            , "/kinstr"
+        );
+    }
+}
+
 void Solver::print_stats_time(
     const double cpu_time,
     const double cpu_time_total,
@@ -2051,6 +2211,7 @@ void Solver::print_norm_stats(
         , stats_line_percent(reduceDB->get_total_time(), cpu_time)
         , "% time"
     );
+    if (conf.hw_counters) print_hw_stats();
 
     //OccSimplifier stats
     if (conf.perform_occur_based_simp) {
@@ -2125,6 +2286,7 @@ void Solver::print_norm_stats(
     } else {
         print_stats_line("c Conflicts in UIP", sumConflicts);
     }
+    frat->print_stats();
     double vm_usage;
     std::string max_mem_usage;
     double max_rss_mem_mb = (double)memUsedTotal(vm_usage, &max_mem_usage)/(1024UL*1024UL);
@@ -2204,6 +2366,7 @@ size_t Solver::mem_used() const
     size_t mem = 0;
     mem += Searcher::mem_used();
     mem += assumptions.capacity()*sizeof(Lit);
+    mem += journal.mem_used();
 
     return mem;
 }
@@ -2311,6 +2474,82 @@ void Solver::print_mem_stats() const
     );
 }
 
+uint64_t Solver::mem_accounted() const
+{
+    uint64_t mem = 0;
+    mem += cl_alloc.mem_used();
+    mem += watches.mem_used_alloc();
+    mem += watches.mem_used_array();
+    mem += mem_used_vardata();
+    mem += mem_used();
+    mem += varReplacer->mem_used();
+    if (occsimplifier) mem += occsimplifier->mem_used();
+    for(const EGaussian* g: gmatrices) if (g) mem += g->mem_used();
+
+    return mem;
+}
+
+// Called every few thousand conflicts and between search iterations when
+// conf.mem_budget_bytes is set. Each solver checks its own data against its
+// share of the budget. Above 80% of it, memory-hungry inprocessing is skipped
+// and the learnt clause database is cut hard, at most once every 20K
+// conflicts unless over the budget. The pressure goes away again below 60%.
+// If the data is over the share even after relief, or the RSS of the whole
+// process is over the full budget, mem_budget_hit makes the search return l_Undef
+// instead of waiting for the OOM killer. The RSS is only a hard stop: it
+// rarely shrinks when memory is freed, so it can't tell when to stop relief.
+void Solver::check_mem_budget()
+{
+    if (conf.mem_budget_bytes == 0) {
+        mem_pressure = false;
+        mem_budget_hit = false;
+        return;
+    }
+    if (!okay()) return;
+
+    const double my_time = cpuTime();
+    const uint64_t share = (double)conf.mem_budget_bytes*conf.mem_budget_share;
+    uint64_t accounted = mem_accounted();
+    if (accounted > share*0.8) mem_pressure = true;
+    else if (accounted < share*0.6) mem_pressure = false;
+
+    double vm_mem_used = 0;
+    uint64_t rss = memUsedTotal(vm_mem_used);
+    const bool over = accounted > share || rss > conf.mem_budget_bytes;
+    bool relieved = false;
+    if (over || (mem_pressure && sumConflicts >= next_mem_relief)) {
+        const PhaseSnapshot before = phase_snapshot();
+        const double backup_ratio[2] = {conf.ratio_keep_clauses[0], conf.ratio_keep_clauses[1]};
+        const uint32_t backup_must_touch = conf.must_touch_lev1_within;
+        for(auto& r: conf.ratio_keep_clauses) r /= 2;
+        conf.must_touch_lev1_within /= 2;
+        reduceDB->handle_lev1();
+        reduceDB->handle_lev2();
+        conf.ratio_keep_clauses[0] = backup_ratio[0];
+        conf.ratio_keep_clauses[1] = backup_ratio[1];
+        conf.must_touch_lev1_within = backup_must_touch;
+        cl_alloc.consolidate(this, true, true);
+        consolidate_watches(true);
+        telemetry.add("mem-budget-relief", before, phase_snapshot());
+        next_mem_relief = sumConflicts + 20000;
+        relieved = true;
+
+        accounted = mem_accounted();
+        rss = memUsedTotal(vm_mem_used);
+    }
+    mem_budget_hit = accounted > share || rss > conf.mem_budget_bytes;
+
+    if (relieved || mem_budget_hit) {
+        verb_print(1, "[mem-budget] close to budget of "
+            << conf.mem_budget_bytes/(1024UL*1024UL) << " MB."
+            << " accounted: " << accounted/(1024UL*1024UL) << " MB"
+            << " rss: " << rss/(1024UL*1024UL) << " MB"
+            << (relieved ? " -- relief done" : "")
+            << (mem_budget_hit ? " -- over budget, stopping" : "")
+            << conf.print_times(cpuTime()-my_time));
+    }
+}
+
 void Solver::print_clause_size_distrib()
 {
     size_t size3 = 0;
@@ -3100,6 +3339,11 @@ void Solver::renumber_xors_to_outside(const vector<Xor>& xors, vector<Xor>& xors
 // and the matrices are created and initialized
 bool Solver::find_and_init_all_matrices() {
     frat_func_start();
+    if (mem_pressure) {
+        verb_print(1, "[find&init matx] close to memory budget, not building matrices");
+        if (gmatrices.empty()) return true;
+        return clear_gauss_matrices(false);
+    }
     if (!xorclauses_updated) {
         if (conf.verbosity >= 2) {
             cout << "c [find&init matx] XORs not updated-> not performing matrix init. Matrices: "
@@ -3134,17 +3378,25 @@ bool Solver::find_and_init_all_matrices() {
 }
 
 // Runs init on all matrices. Note that the XORs inside the matrices
-// are at this point not attached.
+// are at this point not attached. The init of each matrix that is kept is
+// recorded as "gauss-<i>", under the number it has after the deleted ones
+// are removed.
 bool Solver::init_all_matrices() {
     assert(okay());
     assert(decisionLevel() == 0);
 
     assert(gmatrices.size() == gqueuedata.size());
+    uint32_t num_created = 0;
     for (uint32_t i = 0; i < gmatrices.size(); i++) {
         auto& g = gmatrices[i];
         bool created = false;
+        const PhaseSnapshot before = phase_snapshot();
         if (!g->full_init(created)) return false;
         assert(okay());
+        if (created) {
+            telemetry.add("gauss-" + std::to_string(num_created), before, phase_snapshot());
+            num_created++;
+        }
 
         if (!created) {
             gqueuedata[i].disabled = true;
@@ -3308,6 +3560,41 @@ bool Solver::implied_by(const std::vector<Lit>& lits,
     return true;
 }
 
+//"lits" is part of a model, in outer numbering. Drops the ones implied by
+//propagation from the ones kept before them. Banning what is kept bans the
+//same projected model, as all of "lits" follow from it
+void Solver::minimize_projected_model(vector<Lit>& lits)
+{
+    assert(decisionLevel() == 0);
+    if (!okay()) return;
+
+    uint32_t j = 0;
+    uint32_t i = 0;
+    for(; i < lits.size(); i++) {
+        const Lit outer = lits[i];
+        Lit p = varReplacer->get_lit_replaced_with_outer(outer);
+        p = map_outer_to_inter(p);
+        if (p.var() >= nVars() || varData[p.var()].removed != Removed::none) {
+            lits[j++] = outer;
+            continue;
+        }
+        if (value(p) == l_True) continue;
+
+        lits[j++] = outer;
+        if (value(p) == l_False) continue;
+        new_decision_level();
+        enqueue<false>(p);
+        if (!propagate<true>().isnullptr()) {
+            //Cannot happen for a real model, but then keep all
+            i++;
+            break;
+        }
+    }
+    for(; i < lits.size(); i++) lits[j++] = lits[i];
+    lits.resize(j);
+    cancelUntil<false, true>(0);
+}
+
 void Solver::reset_vsids()
 {
     for(auto& x: var_act_vsids) x = 0;
@@ -3472,49 +3759,66 @@ PicoSAT* Solver::build_picosat()
     return picosat;
 }
 
-#ifdef ARJUN_SERIALIZE
 string Solver::serialize_solution_reconstruction_data() const
 {
-    assert(!detached_xor_clauses && "Otherwise we need to extend to detached XORs too");
-
-    std::ostringstream archive_stream;
-    boost::archive::text_oarchive ar(archive_stream);
+    OutArchive ar;
     ar << ok;
     if (ok) {
-        uint32_t nvars = nVars();
-        ar << nvars;
+        ar << (uint64_t)nVarsOuter();
+        ar << minNumVars;
         ar << assigns;
         ar << inter_to_outerMain;
         ar << outer_to_interMain;
-        ar << varData;
-        ar << minNumVars;
+        vector<Removed> removed(nVarsOuter());
+        for(uint32_t i = 0; i < nVarsOuter(); i++) removed[i] = varData[i].removed;
+        ar << removed;
+        ar << undef_must_set_vars;
         CNF::serialize(ar);
         occsimplifier->serialize_elimed_cls(ar);
         varReplacer->serialize_tables(ar);
     }
-    return archive_stream.str();
+    return ar.str();
 }
 
-void Solver::create_from_solution_reconstruction_data(const string& data)
+bool Solver::create_from_solution_reconstruction_data(const string& data)
 {
-    std::istringstream ss(data);
-    boost::archive::text_iarchive ar(ss);
+    assert(nVarsOuter() == 0);
+    InArchive ar(data);
     ar >> ok;
-    if (ok) {
-        uint32_t nvars;
-        ar >> nvars;
-        new_vars(nvars);
-        ar >> assigns;
-        ar >> inter_to_outerMain;
-        ar >> outer_to_interMain;
-        ar >> varData;
-        ar >> minNumVars;
-        CNF::unserialize(ar);
-        occsimplifier->unserialize_elimed_cls(ar);
-        varReplacer->unserialize_tables(ar);
+    if (ar.failed()) return false;
+    if (!ok) return ar.at_end();
+
+    uint64_t nvars = 0;
+    ar >> nvars;
+    if (ar.failed() || nvars > (1ULL << 28)) return false;
+    new_vars(nvars);
+    ar >> minNumVars;
+    ar >> assigns;
+    ar >> inter_to_outerMain;
+    ar >> outer_to_interMain;
+    vector<Removed> removed;
+    ar >> removed;
+    ar >> undef_must_set_vars;
+    CNF::unserialize(ar);
+    occsimplifier->unserialize_elimed_cls(ar);
+    varReplacer->unserialize_tables(ar);
+    if (ar.failed() || !ar.at_end()
+        || minNumVars > nvars
+        || assigns.size() != nvars
+        || inter_to_outerMain.size() != nvars
+        || outer_to_interMain.size() != nvars
+        || removed.size() != nvars
+        || undef_must_set_vars.size() > nvars
+        || get_num_bva_vars() != 0
+    ) {
+        return false;
+    }
+    for(uint32_t i = 0; i < nvars; i++) {
+        if (inter_to_outerMain[i] >= nvars || outer_to_interMain[i] >= nvars) return false;
+        varData[i].removed = removed[i];
     }
+    return true;
 }
-#endif
 
 pair<lbool, vector<lbool>> Solver::extend_minimized_model(const vector<lbool>& m)
 {
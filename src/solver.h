@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "propengine.h"
 #include "searcher.h"
 #include "searchstats.h"
+#include "changejournal.h"
 #ifdef CMS_TESTING_ENABLED
 #include "gtest/gtest_prod.h"
 #endif
@@ -74,6 +75,8 @@ class ReduceDB;
 class InTree;
 class BreakID;
 class GetClauseQuery;
+class OutArchive;
+class InArchive;
 
 struct SolveStats
 {
@@ -112,6 +115,9 @@ class Solver : public Searcher
         void  set_shared_data(SharedData* shared_data);
         vector<Lit> probe_inter_tmp;
         lbool probe_outside(Lit l, uint32_t& min_props);
+        bool add_observed_var(uint32_t outer_var);
+        bool remove_satisfied_clauses();
+        void minimize_projected_model(vector<Lit>& lits);
         void set_max_confl(uint64_t max_confl);
         //frat for SAT problems
         void add_empty_cl_to_frat();
@@ -165,6 +171,13 @@ class Solver : public Searcher
         uint32_t num_active_vars() const;
         void print_mem_stats() const;
         uint64_t print_watch_mem_used(uint64_t total_mem) const;
+
+        //Memory budget, see conf.mem_budget_bytes
+        uint64_t mem_accounted() const;
+        void check_mem_budget();
+        bool mem_pressure = false; ///<Close to the budget, memory-hungry steps are skipped
+        bool mem_budget_hit = false; ///<Over the budget even after relief, search stops
+        uint64_t next_mem_relief = 0; ///<Relief is not repeated before this many conflicts
         const SolveStats& get_solve_stats() const;
         const SearchStats& get_stats() const;
         void add_in_partial_solving_stats();
@@ -196,6 +209,7 @@ class Solver : public Searcher
         StrImplWImpl* dist_impl_with_impl = nullptr;
         CardFinder*            card_finder = nullptr;
         GetClauseQuery*        get_clause_query = nullptr;
+        ChangeJournal          journal;
 
         SearchStats sumSearchStats;
         PropStats sumPropStats;
@@ -205,11 +219,28 @@ class Solver : public Searcher
         bool fully_enqueue_these(const vector<Lit>& toEnqueue);
         bool fully_enqueue_this(const Lit lit_ID);
 
+        //Oracle vivification. oracle_vivif() caps the number of threads at
+        //the hardware threads, oracle_vivif_parallel() takes it as given
+        vector<vector<int>> get_irred_cls_for_oracle() const;
+        void detach_and_free_all_irred_cls();
+        bool oracle_vivif_parallel(vector<vector<int>>& clauses, bool& finished, const uint32_t nthreads);
+        uint32_t oracle_par_threads = 0; ///<Threads of the last parallel run
+        uint64_t oracle_par_shared_units = 0; ///<Units the threads of the last parallel run shared
+
         //State load/unload
         string serialize_solution_reconstruction_data() const;
-        void create_from_solution_reconstruction_data(const string& str);
+        // Returns false if "str" is not valid reconstruction data
+        bool create_from_solution_reconstruction_data(const string& str);
         pair<lbool, vector<lbool>> extend_minimized_model(const vector<lbool>& m);
 
+        //Checkpointing, see solverstate.cpp. Only possible at decision level 0,
+        //without FRAT and BNNs. Loading is only possible into a fresh solver.
+        bool save_state(OutArchive& ar, const uint64_t iteration_num = 0);
+        bool load_state(InArchive& ar);
+        bool save_state_to_file(const string& fname, const uint64_t iteration_num = 0);
+        static bool read_state_file(const string& fname, string& header, string& state);
+        string checkpoint_header; ///<Opaque data of the caller, saved with the state
+
         // Clauses
         bool add_xor_clause_inter(
             const vector< Lit >& lits
@@ -395,21 +426,27 @@ class Solver : public Searcher
             }
         };
 
-        vector<vector<int>> get_irred_cls_for_oracle() const;
         vector<vector<uint16_t>> compute_edge_weights() const;
         vector<OracleDat> order_clauses_for_oracle() const;
         void dump_cls_oracle(const string fname, const vector<OracleDat>& cs);
         bool find_equivs();
         bool oracle_vivif(bool& finished);
+        bool add_back_oracle_cls(const vector<vector<int>>& clauses, const bool red);
         bool oracle_sparsify();
         void print_cs_ordering(const vector<OracleDat>& cs) const;
         template<bool bin_only> bool probe_inter(const Lit l, uint32_t& min_props);
         void reset_for_solving();
         vector<Lit> add_clause_int_tmp_cl;
         lbool iterate_until_solved();
+        template<class T> void serialize_search_state(T& ar);
+        void checkpoint_if_needed(const uint64_t iteration_num);
+        double last_checkpoint_time = 0;
+        uint64_t resume_iteration_num = 0;
         uint64_t mem_used_vardata() const;
         uint64_t calc_num_confl_to_do_this_iter(const size_t iteration_num) const;
-        void detach_and_free_all_irred_cls();
+        bool backbone_native(int64_t orig_max_confl, bool& finished);
+        lbool backbone_search(const uint64_t max_confl);
+        void backbone_flip_filter(const vector<Lit>& cands, vector<char>& dropped) const;
 
         bool sort_and_clean_clause(
             vector<Lit>& ps
@@ -429,12 +466,14 @@ class Solver : public Searcher
         unsigned num_bits_set(const size_t x, const unsigned max_size) const;
         void check_too_large_variable_number(const vector<Lit>& lits) const;
         lbool simplify_problem_outside(const string* strategy = nullptr);
+        void open_hw_counters();
 
         //Stats printing
         void print_norm_stats(
             const double cpu_time,
             const double cpu_time_total,
             const double wallclock_time_started=0) const;
+        void print_hw_stats() const;
         void print_full_stats(
             const double cpu_time,
             const double cpu_time_total,
@@ -461,6 +500,8 @@ class Solver : public Searcher
         uint64_t last_full_watch_consolidate = 0;
         void save_on_var_memory(uint32_t newNumVars);
         void unSaveVarMem();
+        void order_vars_for_locality(vector<uint32_t>& fin, const uint32_t num_effective);
+        bool renumbered_for_locality = false;
         size_t calculate_inter_to_outer_and_outer_to_inter(
             vector<uint32_t>& outer_to_inter
             , vector<uint32_t>& inter_to_outer
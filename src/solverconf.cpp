@@ -299,6 +299,8 @@ DLL_PUBLIC SolverConf::SolverConf() :
 
         //Occur based simplification
         , perform_occur_based_simp(true)
+        , occ_incremental(false)
+        , inprocess_incremental(true)
         , do_strengthen_with_occur       (true)
         , maxRedLinkInSize (50)
         , maxOccurIrredMB  (2500)
@@ -340,6 +342,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         //Memory savings
         , doRenumberVars   (true)
         , must_renumber    (false)
+        , renumber_order   (0)
         , doSaveMem        (true)
         , full_watch_consolidate_every_n_confl (4ULL*1000ULL*1000ULL) //validated in run 8113323.wlm01
 
@@ -369,6 +372,8 @@ DLL_PUBLIC SolverConf::SolverConf() :
         // Oracle
         , oracle_get_learnts(false) // get oracle learnt clauses
         , oracle_removed_is_learnt(false) // clauses removed by Oracle should be learnt
+        , oracle_threads(1) // worker threads for oracle vivification
+        , backbone_native(true) // backbone on our own engine instead of CadiBack
 
         //misc
         , origSeed(0)
@@ -439,6 +439,8 @@ class DLL_PUBLIC SolverConf
 
         //Simplification
         int      perform_occur_based_simp;
+        int      occ_incremental; ///<Restrict repeated occ runs to vars whose irred clauses changed
+        int      inprocess_incremental; ///<Restrict implicit sub/str, implicit cleaning and SCC to what changed
         int      do_strengthen_with_occur;         ///<Perform self-subsuming resolution
         unsigned maxRedLinkInSize;
         double maxOccurIrredMB;
@@ -476,9 +478,11 @@ class DLL_PUBLIC SolverConf
         //Memory savings
         int       doRenumberVars;
         int       must_renumber; ///< if set, all "renumber" is treated as a "must-renumber"
+        int       renumber_order; ///<0 = compact only, 1 = BFS over the clause graph, 2 = Louvain communities (STATS_NEEDED builds, BFS otherwise)
         int       doSaveMem;
         uint64_t  full_watch_consolidate_every_n_confl;
         int must_always_conslidate = 0; // only used for debugging
+        int consolidate_by_tier = 0; ///<Consolidate irredundant and tier-0 clauses first, then tier-1, from the hottest watchlists down
 
         //Misc Optimisations
         int      doStrSubImplicit;
@@ -505,6 +509,8 @@ class DLL_PUBLIC SolverConf
         double global_timeout_multiplier_multiplier;
         double global_multiplier_multiplier_max;
         double var_and_mem_out_mult;
+        uint64_t mem_budget_bytes = 0; ///<Whole-process memory budget, 0 means unlimited
+        double   mem_budget_share = 1.0; ///<Share of mem_budget_bytes this solver's data may take
 
         //Multi-thread, MPI
         unsigned long long sync_every_confl;
@@ -515,11 +521,19 @@ class DLL_PUBLIC SolverConf
         // Oracle
         int oracle_get_learnts; // get oracle learnt clauses
         int oracle_removed_is_learnt; // clauses removed by Oracle should be learnt
+        uint32_t oracle_threads; // worker threads for oracle vivification
+        int backbone_native; // backbone on our own engine instead of CadiBack
 
         //Misc
         unsigned origSeed;
         int      idrup = 0;
+        int      proof_gzip_level = 0; ///<If >0, FRAT/IDRUP output is gzip compressed at this level
         int      conf_needed = true;
+        int      hw_counters = 0; ///<Attribute hardware performance counters to phases, Linux only
+
+        //Checkpointing
+        string   checkpoint_fname; ///<If set, the state is periodically saved here
+        double   checkpoint_every_secs = 600;
 };
 
 } //end namespace
@@ -0,0 +1,382 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+// Checkpointing: saving the full state of the solver at decision level 0,
+// and loading it back into a fresh solver. Everything is kept in INTERNAL
+// numbering, so the maps, per-variable heuristics and clauses are restored
+// as they were, and search continues where it was left off.
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "solver.h"
+#include "occsimplifier.h"
+#include "varreplacer.h"
+#include "gaussian.h"
+#include "serializer.h"
+#include "time_mem.h"
+#include "GitSHA1.h"
+
+using namespace CMSat;
+
+namespace {
+static const char* state_magic = "cms-state-1";
+
+struct VarFlags {
+    Removed removed;
+    uint8_t stable_polarity;
+    uint8_t saved_polarity;
+    uint8_t best_polarity;
+    uint8_t inv_polarity;
+    uint8_t is_bva;
+    uint8_t occ_simp_tried;
+};
+
+struct BinCl {
+    Lit lit1;
+    Lit lit2;
+    uint8_t red;
+};
+}
+
+// Saves the search heuristics, schedules and statistics that are not
+// derived from the clauses
+template<class T>
+void Solver::serialize_search_state(T& ar)
+{
+    ar & sumConflicts & sumDecisions & sumAntecedents & sumPropagations
+        & sumConflictClauseLits & sumAntecedentsLits & sumDecisionBasedCl
+        & sumClLBD & sumClSize;
+    ar & var_inc_vsids & var_decay & max_vsids_act & cla_inc & max_cl_act & stats_bumped;
+    ar & branch_strategy & branch_strategy_str & branch_strategy_str_short
+        & branch_strategy_num & branch_strategy_at & branch_strategy_change;
+    ar & polarity_mode & polarity_strategy_at & polarity_strategy_change;
+    ar & longest_trail_ever_stable & longest_trail_ever_best & longest_trail_ever_inv;
+    ar & cur_rest_type & restart_strategy_at & restart_strategy_change
+        & increasing_phase_size & luby_loop_num;
+    ar & next_lev1_reduce & next_lev2_reduce & next_pred_reduce
+        & next_cls_distill & next_bins_distill & next_str_impl_with_impl
+        & next_full_probe & full_probe_iter & next_sub_str_with_bin
+        & next_intree & next_sls & num_sls_called;
+    ar & solveStats & sumSearchStats & sumPropStats;
+    ar & conf.global_timeout_multiplier & conf.glue_put_lev0_if_below_or_eq
+        & adjusted_glue_cutoff_if_too_many & cur_max_temp_red_lev2_cls;
+    ar & conf.sampling_vars & conf.sampling_vars_set
+        & conf.opt_sampling_vars & conf.opt_sampling_vars_set;
+}
+
+// Tiny adaptors so that serialize_search_state() can be written once,
+// boost-style, for both directions
+namespace {
+struct SaveAr {
+    OutArchive& ar;
+    template<class X> SaveAr& operator&(const X& x) { ar << x; return *this; }
+};
+struct LoadAr {
+    InArchive& ar;
+    template<class X> LoadAr& operator&(X& x) { ar >> x; return *this; }
+};
+}
+
+bool Solver::save_state(OutArchive& ar, const uint64_t iteration_num)
+{
+    if (frat->enabled() || decisionLevel() != 0) return false;
+    for(const auto& b: bnns) if (b != nullptr) return false;
+
+    const uint32_t n = nVarsOuter();
+    ar << (uint64_t)n << ok;
+    if (!ok) return true;
+
+    ar << inter_to_outerMain << outer_to_interMain << assigns;
+    vector<VarFlags> flags(n);
+    for(uint32_t i = 0; i < n; i++) {
+        const VarData& vd = varData[i];
+        flags[i] = VarFlags{vd.removed, vd.stable_polarity, vd.saved_polarity,
+            vd.best_polarity, vd.inv_polarity, vd.is_bva, vd.occ_simp_tried};
+    }
+    ar << flags << var_act_vsids << vmtf_btab;
+    ar << undef_must_set_vars;
+    CNF::serialize(ar);
+    occsimplifier->serialize_elimed_cls(ar);
+    varReplacer->serialize_tables(ar);
+
+    // Clauses
+    vector<BinCl> bins;
+    for(uint32_t i = 0; i < nVars()*2; i++) {
+        const Lit l = Lit::toLit(i);
+        for(const auto& w: watches[l]) {
+            if (w.isBin() && l < w.lit2()) bins.push_back(BinCl{l, w.lit2(), w.red()});
+        }
+    }
+    ar << bins;
+
+    vector<Lit> lits;
+    vector<ClauseStats> cl_stats;
+    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+    vector<ClauseStatsExtra> cl_stats_extra;
+    #endif
+    auto add_cls = [&](const vector<ClOffset>& offs) {
+        for(const ClOffset off: offs) {
+            const Clause* cl = cl_alloc.ptr(off);
+            if (cl->freed() || cl->get_removed()) continue;
+            for(const Lit l: *cl) lits.push_back(l);
+            lits.push_back(lit_Undef);
+            cl_stats.push_back(cl->stats);
+            #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+            if (cl->red()) cl_stats_extra.push_back(red_stats_extra[cl->stats.extra_pos]);
+            #endif
+        }
+    };
+    add_cls(longIrredCls);
+    ar << lits << cl_stats;
+    lits.clear();
+    cl_stats.clear();
+    for(const auto& cls: longRedCls) add_cls(cls);
+    ar << lits << cl_stats;
+    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+    ar << cl_stats_extra;
+    #endif
+
+    // XORs, both the attached ones and the ones inside matrices
+    vector<uint32_t> xor_vars;
+    vector<uint8_t> xor_rhs;
+    auto add_xors = [&](const vector<Xor>& xors) {
+        for(const auto& x: xors) {
+            for(const uint32_t v: x) xor_vars.push_back(v);
+            xor_vars.push_back(var_Undef);
+            xor_rhs.push_back(x.rhs);
+        }
+    };
+    add_xors(xorclauses);
+    for(const auto& g: gmatrices) if (g) add_xors(g->xorclauses);
+    ar << xor_vars << xor_rhs;
+
+    SaveAr sar{ar};
+    serialize_search_state(sar);
+    ar << iteration_num;
+    return true;
+}
+
+bool Solver::load_state(InArchive& ar)
+{
+    assert(nVarsOuter() == 0);
+    if (frat->enabled()) return false;
+
+    uint64_t n = 0;
+    bool saved_ok = true;
+    ar >> n >> saved_ok;
+    if (ar.failed() || n > (1ULL << 28)) return false;
+    new_vars(n);
+    if (!saved_ok) {
+        ok = false;
+        return true;
+    }
+
+    vector<lbool> saved_assigns;
+    vector<VarFlags> flags;
+    vector<double> act;
+    vector<uint64_t> btab;
+    ar >> inter_to_outerMain >> outer_to_interMain >> saved_assigns;
+    ar >> flags >> act >> btab;
+    ar >> undef_must_set_vars;
+    CNF::unserialize(ar);
+    occsimplifier->unserialize_elimed_cls(ar);
+    varReplacer->unserialize_tables(ar);
+    if (ar.failed()
+        || inter_to_outerMain.size() != n
+        || outer_to_interMain.size() != n
+        || saved_assigns.size() != n
+        || flags.size() != n
+        || act.size() > n
+        || btab.size() > n
+        || undef_must_set_vars.size() > n
+    ) {
+        return false;
+    }
+    for(uint32_t i = 0; i < n; i++) {
+        if (inter_to_outerMain[i] >= n || outer_to_interMain[inter_to_outerMain[i]] != i) return false;
+        VarData& vd = varData[i];
+        vd.removed = flags[i].removed;
+        vd.stable_polarity = flags[i].stable_polarity;
+        vd.saved_polarity = flags[i].saved_polarity;
+        vd.best_polarity = flags[i].best_polarity;
+        vd.inv_polarity = flags[i].inv_polarity;
+        vd.is_bva = flags[i].is_bva;
+        vd.occ_simp_tried = flags[i].occ_simp_tried;
+        var_act_vsids[i] = i < act.size() ? act[i] : 0;
+        vmtf_btab[i] = i < btab.size() ? btab[i] : 0;
+    }
+
+    auto var_ok = [&](const uint32_t v) {
+        return v < n && varData[v].removed == Removed::none;
+    };
+
+    // Clauses, before the units, as attaching needs no pending propagation
+    vector<BinCl> bins;
+    ar >> bins;
+    for(const auto& b: bins) {
+        if (!var_ok(b.lit1.var()) || !var_ok(b.lit2.var()) || b.lit1.var() == b.lit2.var()) {
+            return false;
+        }
+        attach_bin_clause(b.lit1, b.lit2, b.red, ++clauseID);
+    }
+
+    vector<Lit> lits;
+    vector<Lit> cl;
+    vector<ClauseStats> cl_stats;
+    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+    vector<ClauseStatsExtra> cl_stats_extra;
+    #endif
+    for(const bool red: {false, true}) {
+        ar >> lits >> cl_stats;
+        #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+        if (red) ar >> cl_stats_extra;
+        if (red && cl_stats_extra.size() != cl_stats.size()) return false;
+        #endif
+        if (ar.failed()) return false;
+        size_t at = 0;
+        for(const Lit l: lits) {
+            if (l != lit_Undef) {
+                if (!var_ok(l.var())) return false;
+                cl.push_back(l);
+                continue;
+            }
+            if (at >= cl_stats.size() || cl.size() < 3) return false;
+            ClauseStats cl_st = cl_stats[at];
+            #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+            cl_st.extra_pos = numeric_limits<uint32_t>::max();
+            #endif
+            if (red && cl_st.which_red_array >= longRedCls.size()) return false;
+            Clause* c = add_clause_int(cl, red, &cl_st, true, nullptr, false);
+            if (c != nullptr) {
+                const ClOffset off = cl_alloc.get_offset(c);
+                if (red) {
+                    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+                    red_stats_extra.push_back(cl_stats_extra[at]);
+                    c->stats.extra_pos = red_stats_extra.size()-1;
+                    #endif
+                    longRedCls[c->stats.which_red_array].push_back(off);
+                } else {
+                    longIrredCls.push_back(off);
+                }
+            }
+            if (!okay()) return false;
+            at++;
+            cl.clear();
+        }
+        if (at != cl_stats.size() || !cl.empty()) return false;
+    }
+
+    vector<uint32_t> xor_vars;
+    vector<uint8_t> xor_rhs;
+    ar >> xor_vars >> xor_rhs;
+    size_t at = 0;
+    vector<uint32_t> vars;
+    for(const uint32_t v: xor_vars) {
+        if (v != var_Undef) {
+            if (!var_ok(v)) return false;
+            vars.push_back(v);
+            continue;
+        }
+        if (at >= xor_rhs.size()) return false;
+        xorclauses.push_back(Xor(vars, xor_rhs[at++]));
+        vars.clear();
+    }
+    if (at != xor_rhs.size() || !vars.empty()) return false;
+
+    LoadAr lar{ar};
+    serialize_search_state(lar);
+    uint64_t iteration_num = 0;
+    ar >> iteration_num;
+    if (ar.failed() || !ar.at_end()) return false;
+    resume_iteration_num = iteration_num;
+
+    // Units at level 0, then everything is propagated again
+    for(uint32_t i = 0; i < n; i++) {
+        if (saved_assigns[i] == l_Undef) continue;
+        if (varData[i].removed != Removed::none) return false;
+        enqueue<false>(Lit(i, saved_assigns[i] == l_False));
+    }
+    ok = propagate<true>().isnullptr();
+    if (ok) ok = attach_xorclauses();
+    xorclauses_updated = true;
+
+    rebuildOrderHeap();
+    return true;
+}
+
+bool Solver::save_state_to_file(const string& fname, const uint64_t iteration_num)
+{
+    OutArchive state;
+    if (!save_state(state, iteration_num)) return false;
+
+    OutArchive ar;
+    ar << string(state_magic) << string(get_version_sha1()) << checkpoint_header << state.str();
+
+    const string tmp_fname = fname + ".tmp";
+    std::ofstream f(tmp_fname.c_str(), std::ios::binary);
+    f.write(ar.str().data(), ar.str().size());
+    f.close();
+    if (!f || std::rename(tmp_fname.c_str(), fname.c_str()) != 0) {
+        std::remove(tmp_fname.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Solver::read_state_file(const string& fname, string& header, string& state)
+{
+    std::ifstream f(fname.c_str(), std::ios::binary);
+    if (!f) return false;
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const string data = ss.str();
+
+    InArchive ar(data);
+    string magic;
+    string sha1;
+    ar >> magic >> sha1 >> header >> state;
+    return !ar.failed() && ar.at_end()
+        && magic == state_magic
+        && sha1 == get_version_sha1();
+}
+
+void Solver::checkpoint_if_needed(const uint64_t iteration_num)
+{
+    if (conf.checkpoint_fname.empty()
+        || conf.thread_num != 0
+        || real_time_sec() - last_checkpoint_time < conf.checkpoint_every_secs
+    ) {
+        return;
+    }
+
+    const double my_time = real_time_sec();
+    const bool saved = save_state_to_file(conf.checkpoint_fname, iteration_num);
+    last_checkpoint_time = real_time_sec();
+    if (!saved) {
+        cout << "c WARNING: could not save checkpoint to '" << conf.checkpoint_fname << "'" << endl;
+    } else {
+        verb_print(1, "[checkpoint] saved to '" << conf.checkpoint_fname << "'"
+            << " T: " << std::setprecision(2) << std::fixed << (last_checkpoint_time - my_time));
+    }
+}
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include <iostream>
 #include <cassert>
 #include <vector>
+#include <string>
 #include <array>
 #include <algorithm>
 
@@ -276,6 +277,72 @@ struct FastBackwData {
     uint64_t start_sumConflicts;
 };
 
+// Telemetry of one phase of solving (a simplification strategy token such
+// as "occ-bve", "search", "reducedb-lev2", "gauss"), summed over all times
+// it ran. "gauss-<i>" times the init of Gauss matrix <i>, and adds the
+// propagations and conflicts of that matrix. Removed counts are net, they are negative if the phase added more
+// than it removed. Literals count binary clauses as two literals.
+struct PhaseStats {
+    std::string name;
+    uint64_t calls = 0;
+    double wall_time = 0;
+    double cpu_time = 0;
+    uint64_t propagations = 0;
+    uint64_t conflicts = 0;
+    int64_t mem_delta_bytes = 0;
+    int64_t vars_removed = 0;
+    int64_t lits_removed = 0;
+
+    // Hardware counters of the thread, user space only. Zero unless
+    // enabled with SolverConf::hw_counters and supported by the system.
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+    uint64_t branch_misses = 0;
+};
+
+// Learnt clause export. Clauses are handed over in batches, each clause
+// terminated by lit_Undef, using the same numbering as add_clause()
+struct LearntExport {
+    void* state = nullptr;
+    void (*learn)(void* state, const std::vector<Lit>& cls) = nullptr;
+    uint32_t max_len = 0;
+};
+
+// External (user) propagator, in the style of IPASIR-UP. All literals use the
+// same numbering as add_clause(). Clauses handed over by the propagator may
+// only contain observed variables. Misuse of the interface makes solve()
+// throw std::runtime_error, after which the solver must not be used again.
+class ExternalPropagator {
+public:
+    virtual ~ExternalPropagator() = default;
+
+    // Observed variables have been assigned. Assignments at decision level 0
+    // are final, and may be reported again by a later call to solve()
+    virtual void notify_assignment(const std::vector<Lit>& lits) = 0;
+    virtual void notify_new_decision_level() = 0;
+    // All assignments above decision level "new_level" are undone
+    virtual void notify_backtrack(uint32_t new_level) = 0;
+
+    // Return a literal implied by the current assignment, or lit_Undef.
+    // Its reason clause is only asked for when conflict analysis needs it,
+    // while the literal is still assigned. It must contain the literal
+    // itself, all other literals being FALSE and assigned before it.
+    // Reasons are not kept as clauses
+    virtual Lit propagate() { return lit_Undef; }
+    virtual void add_reason_clause(Lit propagated, std::vector<Lit>& reason) = 0;
+
+    // Fill "cl" and return true to add a clause, return false if there are
+    // no more clauses to add. Clauses are irredundant unless "forgettable"
+    // is set, in which case they are redundant and may be deleted
+    virtual bool has_external_clause(std::vector<Lit>& /*cl*/, bool& /*forgettable*/) { return false; }
+
+    // Called with the values of the observed variables, indexed by variable,
+    // once all variables are set. When returning false, at least one clause
+    // must be handed over through has_external_clause()
+    virtual bool check_found_model(const std::vector<lbool>& /*model*/) { return true; }
+};
+
 class BNN
 {
 public:
@@ -46,17 +46,33 @@ bool StrImplWImpl::str_impl_w_impl()
     if (solver->watches.size() == 0)
         return solver->okay();
 
-    //Randomize starting point
-    size_t upI = rnd_uint(solver->mtrand, solver->watches.size()-1);
-    size_t numDone = 0;
-    for (; numDone < solver->watches.size() && timeAvailable > 0
-        ; upI = (upI +1) % solver->watches.size(), numDone++
-
-    ) {
-        str_impl_data.numWatchesLooked++;
-        const Lit lit = Lit::toLit(upI);
-        distill_implicit_with_implicit_lit(lit);
+    //Both binaries of a pair are in the same watchlist, so if the last run
+    //got through everything, only watchlists with a new binary can have a new pair
+    bool incremental = solver->conf.inprocess_incremental
+        && last_run_complete
+        && !solver->journal.all_changed_since(journal_at);
+    if (incremental) solver->journal.bin_lits_since(journal_at, solver->nVars(), dirty);
+    journal_at = solver->journal.now();
+
+    if (incremental) {
+        for (size_t i = 0; i < dirty.size() && timeAvailable > 0; i++) {
+            str_impl_data.numWatchesLooked++;
+            distill_implicit_with_implicit_lit(dirty[i]);
+        }
+    } else {
+        //Randomize starting point
+        size_t upI = rnd_uint(solver->mtrand, solver->watches.size()-1);
+        size_t numDone = 0;
+        for (; numDone < solver->watches.size() && timeAvailable > 0
+            ; upI = (upI +1) % solver->watches.size(), numDone++
+
+        ) {
+            str_impl_data.numWatchesLooked++;
+            const Lit lit = Lit::toLit(upI);
+            distill_implicit_with_implicit_lit(lit);
+        }
     }
+    last_run_complete = timeAvailable > 0;
 
     //Enqueue delayed values
     if (!solver->fully_enqueue_these(str_impl_data.toEnqueue))
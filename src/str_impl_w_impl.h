@@ -84,6 +84,11 @@ private:
     StrImplicitData str_impl_data;
     int64_t timeAvailable;
     vector<Lit> lits;
+
+    //Incremental runs, see conf.inprocess_incremental
+    uint64_t journal_at = 0;
+    bool last_run_complete = false;
+    vector<Lit> dirty;
 };
 
 }
@@ -24,8 +24,11 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <iomanip>
 #include <limits>
 #include <string>
+#include <vector>
 #include <memory>
 #include <cmath>
+#include <cstring>
+#include <algorithm>
 
 using std::numeric_limits;
 
@@ -68,6 +71,22 @@ struct CH {
     }
 };
 
+//A range of memory, e.g. a memory-mapped file
+struct MemRange {
+    const char* at;
+    const char* end;
+};
+
+struct MEM {
+    static inline int read(void* buf, size_t num, size_t count, MemRange& f)
+    {
+        const size_t toread = std::min<size_t>(num*count, f.end - f.at);
+        memcpy(buf, f.at, toread);
+        f.at += toread;
+        return toread;
+    }
+};
+
 template<typename A, typename B>
 class StreamBuffer
 {
@@ -75,11 +94,12 @@ class StreamBuffer
     void assureLookahead() {
         if (pos >= size) {
             pos  = 0;
-            size = B::read(buf.get(), 1, chunk_limit, in);
+            size = B::read(buf.get(), 1, buf_size, in);
         }
     }
     int     pos;
     int     size;
+    unsigned buf_size;
     std::unique_ptr<char[]> buf;
 
     void advance()
@@ -92,11 +112,12 @@ class StreamBuffer
     }
 
 public:
-    StreamBuffer(A i) :
+    StreamBuffer(A i, unsigned _buf_size = chunk_limit) :
         in(i)
         , pos(0)
         , size(0)
-        , buf(new char[chunk_limit]())
+        , buf_size(_buf_size)
+        , buf(new char[_buf_size]())
     {
         assureLookahead();
     }
@@ -222,6 +243,22 @@ public:
         return true;
     }
 
+    //Appends all remaining input to "out", for binary formats
+    void read_rest(std::vector<char>& out)
+    {
+        for(;;) {
+            if (pos < size) {
+                out.insert(out.end(), buf.get() + pos, buf.get() + size);
+            }
+            pos = size = 0;
+            size = B::read(buf.get(), 1, buf_size, in);
+            if (size <= 0) {
+                size = 0;
+                return;
+            }
+        }
+    }
+
     void parseString(std::string& str)
     {
         str.clear();
@@ -136,15 +136,30 @@ void SubsumeImplicit::subsume_implicit(const bool check_stats, std::string calle
         return;
     }
 
-    //Randomize starting point
-    const size_t rnd_start = rnd_uint(solver->mtrand, solver->watches.size()-1);
-    size_t numDone = 0;
-    for (;numDone < solver->watches.size() && timeAvailable > 0 && !solver->must_interrupt_asap()
-         ;numDone++
-    ) {
-        const size_t at = (rnd_start + numDone)  % solver->watches.size();
-        subsume_at_watch(at, &timeAvailable);
+    //Only a new binary can be a duplicate. If the last run got through
+    //everything, only watchlists with a new binary need to be looked at
+    const bool incremental = solver->conf.inprocess_incremental
+        && last_run_complete
+        && !solver->journal.all_changed_since(journal_at);
+    if (incremental) solver->journal.bin_lits_since(journal_at, solver->nVars(), dirty);
+    journal_at = solver->journal.now();
+
+    if (incremental) {
+        for (size_t i = 0; i < dirty.size() && timeAvailable > 0 && !solver->must_interrupt_asap(); i++) {
+            subsume_at_watch(dirty[i].toInt(), &timeAvailable);
+        }
+    } else {
+        //Randomize starting point
+        const size_t rnd_start = rnd_uint(solver->mtrand, solver->watches.size()-1);
+        size_t numDone = 0;
+        for (;numDone < solver->watches.size() && timeAvailable > 0 && !solver->must_interrupt_asap()
+             ;numDone++
+        ) {
+            const size_t at = (rnd_start + numDone)  % solver->watches.size();
+            subsume_at_watch(at, &timeAvailable);
+        }
     }
+    last_run_complete = timeAvailable > 0 && !solver->must_interrupt_asap();
 
     const double time_used = cpuTime() - my_time;
     const bool time_out = (timeAvailable <= 0);
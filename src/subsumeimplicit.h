@@ -76,6 +76,11 @@ private:
     Stats runStats;
     Stats globalStats;
 
+    //Incremental runs, see conf.inprocess_incremental
+    uint64_t journal_at = 0;
+    bool last_run_complete = false;
+    vector<Lit> dirty;
+
     void clear()
     {
         lastLit2 = lit_Undef;
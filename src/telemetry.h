@@ -0,0 +1,129 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+
+#include "solvertypesmini.h"
+#include "hwcounters.h"
+
+namespace CMSat {
+
+// Counters taken before and after a phase, see Searcher::phase_snapshot()
+struct PhaseSnapshot {
+    double wall_time;
+    double cpu_time;
+    uint64_t propagations;
+    uint64_t conflicts;
+    int64_t mem;
+    int64_t free_vars;
+    int64_t lits;
+    HwCounts hw;
+};
+
+// Per-phase totals. There are only a few dozen phase names, so a linear
+// search is cheaper than a map
+class Telemetry {
+public:
+    void add(const std::string& name, const PhaseSnapshot& before, const PhaseSnapshot& after)
+    {
+        PhaseStats& p = get(name);
+        p.calls++;
+        p.wall_time += after.wall_time - before.wall_time;
+        p.cpu_time += after.cpu_time - before.cpu_time;
+        p.propagations += after.propagations - before.propagations;
+        p.conflicts += after.conflicts - before.conflicts;
+        p.mem_delta_bytes += after.mem - before.mem;
+        p.vars_removed += before.free_vars - after.free_vars;
+        p.lits_removed += before.lits - after.lits;
+        add_hw(p, before.hw, after.hw);
+    }
+
+    // For phases too short and frequent for a full snapshot, such as
+    // propagation and conflict analysis, which are sampled. A sample with a
+    // failed read is dropped
+    void add_hw(const std::string& name, const HwCounts& before, const HwCounts& after)
+    {
+        if (!before.valid || !after.valid) return;
+        PhaseStats& p = get(name);
+        p.calls++;
+        add_hw(p, before, after);
+    }
+
+    PhaseStats& get(const std::string& name)
+    {
+        for(auto& p: phases) if (p.name == name) return p;
+        phases.push_back(PhaseStats());
+        phases.back().name = name;
+        return phases.back();
+    }
+
+    const std::vector<PhaseStats>& get_phases() const { return phases; }
+    void clear() { phases.clear(); }
+
+    static std::string to_json(const std::vector<PhaseStats>& ps)
+    {
+        std::stringstream ss;
+        ss << std::setprecision(6) << std::fixed;
+        ss << "{\"phases\": [";
+        for(size_t i = 0; i < ps.size(); i++) {
+            const PhaseStats& p = ps[i];
+            if (i > 0) ss << ",";
+            // Phase names are strategy tokens, they need no escaping
+            ss << "\n  {\"name\": \"" << p.name << "\""
+            << ", \"calls\": " << p.calls
+            << ", \"wall_time\": " << p.wall_time
+            << ", \"cpu_time\": " << p.cpu_time
+            << ", \"propagations\": " << p.propagations
+            << ", \"conflicts\": " << p.conflicts
+            << ", \"mem_delta_bytes\": " << p.mem_delta_bytes
+            << ", \"vars_removed\": " << p.vars_removed
+            << ", \"lits_removed\": " << p.lits_removed
+            << ", \"cycles\": " << p.cycles
+            << ", \"instructions\": " << p.instructions
+            << ", \"cache_misses\": " << p.cache_misses
+            << ", \"branch_misses\": " << p.branch_misses
+            << "}";
+        }
+        ss << "\n]}\n";
+        return ss.str();
+    }
+
+private:
+    static void add_hw(PhaseStats& p, const HwCounts& before, const HwCounts& after)
+    {
+        if (!before.valid || !after.valid) return;
+        p.cycles += after.cycles - before.cycles;
+        p.instructions += after.instructions - before.instructions;
+        p.cache_misses += after.cache_misses - before.cache_misses;
+        p.branch_misses += after.branch_misses - before.branch_misses;
+    }
+
+    std::vector<PhaseStats> phases;
+};
+
+}
@@ -65,6 +65,11 @@ public:
         return touched;
     }
 
+    bool touched_var(const uint32_t var) const
+    {
+        return var < touchedBitset.size() && touchedBitset[var];
+    }
+
     void clear()
     {
         //Clear touchedBitset
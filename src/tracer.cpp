@@ -0,0 +1,81 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "tracer.h"
+
+using namespace CMSat;
+
+Tracer::Tracer(const std::string& fname) :
+    start(std::chrono::steady_clock::now())
+{
+    f = fopen(fname.c_str(), "w");
+    if (f) fputs("[\n", f);
+}
+
+Tracer::~Tracer()
+{
+    if (f) fclose(f);
+}
+
+void Tracer::write(const std::string& events)
+{
+    if (!f || events.empty()) return;
+    std::lock_guard<std::mutex> lock(mu);
+    fwrite(events.data(), 1, events.size(), f);
+    fflush(f);
+}
+
+TraceBuffer::TraceBuffer(Tracer* _tracer, const uint32_t _tid) :
+    tracer(_tracer), tid(_tid)
+{
+    buf += "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": ";
+    buf += std::to_string(tid);
+    buf += ", \"args\": {\"name\": \"solver thread ";
+    buf += std::to_string(tid);
+    buf += "\"}},\n";
+}
+
+// Complete ("X") events, names are strategy tokens and fixed strings that
+// need no JSON escaping
+void TraceBuffer::span(const char* name, const uint64_t start_us, const uint64_t end_us)
+{
+    buf += "{\"name\": \"";
+    buf += name;
+    buf += "\", \"ph\": \"X\", \"pid\": 1, \"tid\": ";
+    buf += std::to_string(tid);
+    buf += ", \"ts\": ";
+    buf += std::to_string(start_us);
+    buf += ", \"dur\": ";
+    buf += std::to_string(end_us - start_us);
+    buf += "},\n";
+    // Sparse events of long runs are written out at least every second
+    if (buf.size() > (1U << 16) || end_us > last_flush_us + 1000000) {
+        flush();
+        last_flush_us = end_us;
+    }
+}
+
+void TraceBuffer::flush()
+{
+    tracer->write(buf);
+    buf.clear();
+}
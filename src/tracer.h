@@ -0,0 +1,98 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <mutex>
+#include <chrono>
+
+namespace CMSat {
+
+// Timeline of solver activity in the Chrome trace event format, viewable in
+// chrome://tracing or Perfetto. One Tracer (i.e. one file) is shared by all
+// threads of a SATSolver, each thread writes through its own TraceBuffer.
+// The array is never closed on purpose, the format allows that, so that a
+// killed run still leaves a usable trace.
+class Tracer {
+public:
+    // Check ok() afterwards
+    explicit Tracer(const std::string& fname);
+    ~Tracer();
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    bool ok() const { return f != nullptr; }
+    uint64_t now_us() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+    void write(const std::string& events);
+
+private:
+    FILE* f = nullptr;
+    std::mutex mu;
+    const std::chrono::steady_clock::time_point start;
+};
+
+// Per-thread event buffer, written to the Tracer in large chunks
+class TraceBuffer {
+public:
+    TraceBuffer(Tracer* _tracer, uint32_t _tid);
+    ~TraceBuffer() { flush(); }
+    TraceBuffer(const TraceBuffer&) = delete;
+    TraceBuffer& operator=(const TraceBuffer&) = delete;
+
+    uint64_t now_us() const { return tracer->now_us(); }
+    void span(const char* name, uint64_t start_us, uint64_t end_us);
+    void flush();
+
+private:
+    Tracer* tracer;
+    const uint32_t tid;
+    std::string buf;
+    uint64_t last_flush_us = 0;
+};
+
+// Emits a span for its own lifetime. With a nullptr buffer, i.e. tracing
+// off, it costs a single branch
+class TraceSpan {
+public:
+    TraceSpan(TraceBuffer* _trace, const char* _name) : trace(_trace), name(_name) {
+        if (trace) start_us = trace->now_us();
+    }
+    TraceSpan(TraceBuffer* _trace, const std::string& _name) : TraceSpan(_trace, _name.c_str()) {}
+    ~TraceSpan() {
+        if (trace) trace->span(name, start_us, trace->now_us());
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    TraceBuffer* trace;
+    const char* name;
+    uint64_t start_us = 0;
+};
+
+}
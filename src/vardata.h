@@ -36,6 +36,7 @@ struct VarData
     VarData([[maybe_unused]] uint32_t num) {
         is_bva = 0;
         occ_simp_tried = 0;
+        observed = 0;
         saved_polarity = false;
         stable_polarity = false;
         best_polarity = false;
@@ -71,6 +72,7 @@ struct VarData
     uint8_t inv_polarity:1;
     uint8_t is_bva:1;
     uint8_t occ_simp_tried:1;
+    uint8_t observed:1; ///<Watched by the external propagator, must not be eliminated
     bool propagated = false;
 
     #if defined(STATS_NEEDED)
@@ -439,6 +439,7 @@ inline void VarReplacer::updateBin(
         i->set_ID(ID);
     }
 
+    if (lit1 != origLit1 || lit2 != origLit2) solver->journal.touch_bin(lit1, lit2);
     if (lit1 != origLit1) {
         solver->watches[lit1].push(*i);
     } else {
@@ -940,6 +941,12 @@ bool VarReplacer::replace( uint32_t var1 , uint32_t var2 , const bool xor_is_tru
 
     assert(val1 == l_Undef && val2 == l_Undef);
 
+    //Whichever one ends up representing the other, it must stay observed
+    if (solver->varData[lit1.var()].observed || solver->varData[lit2.var()].observed) {
+        solver->varData[lit1.var()].observed = 1;
+        solver->varData[lit2.var()].observed = 1;
+    }
+
     const Lit lit1_outer = solver->map_inter_to_outer(lit1);
     const Lit lit2_outer = solver->map_inter_to_outer(lit2);
     return update_table_and_reversetable(lit1_outer, lit2_outer);
@@ -1036,7 +1043,7 @@ bool VarReplacer::replace_if_enough_is_found(const size_t limit, uint64_t* bogop
 
     scc_finder->performSCC(bogoprops_given);
     if (scc_finder->get_num_binxors_found() < limit) {
-        scc_finder->clear_binxors();
+        scc_finder->discard_binxors();
         return solver->okay();
     }
     assert(solver->gmatrices.empty());
@@ -71,10 +71,8 @@ class VarReplacer
         uint32_t get_var_replaced_with_outer(uint32_t var) const;
         bool var_is_replacing(const uint32_t var);
 
-#ifdef ARJUN_SERIALIZE
         template<class T> void unserialize_tables(T& ar);
         template<class T> void serialize_tables  (T& ar) const;
-#endif
 
         vector<uint32_t> get_vars_replacing(uint32_t var) const;
         void updateVars(
@@ -323,12 +321,12 @@ inline uint32_t VarReplacer::get_var_replaced_with_outer(uint32_t var) const
     return table[var].var();
 }
 
-#ifdef ARJUN_SERIALIZE
 template<class T>
 void VarReplacer::serialize_tables(T& ar) const
 {
     ar << table;
     ar << reverseTable;
+    ar << replacedVars << lastReplacedVars;
 }
 
 template<class T>
@@ -336,7 +334,7 @@ void VarReplacer::unserialize_tables(T& ar)
 {
     ar >> table;
     ar >> reverseTable;
+    ar >> replacedVars >> lastReplacedVars;
 }
-#endif
 
 } //end namespace
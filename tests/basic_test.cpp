@@ -24,11 +24,15 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <fstream>
+#include <memory>
+#include <functional>
 
 #include "cryptominisat5/cryptominisat.h"
+#include "cryptominisat5/binarycnf.h"
 #include "src/solverconf.h"
 #include "test_helper.h"
 #include <vector>
+#include <random>
 
 using namespace CMSat;
 using std::vector;
@@ -695,6 +699,29 @@ TEST(error_throw, multithread_drat)
         , std::runtime_error);
 }
 
+TEST(frat, proof_written_by_end)
+{
+    FILE* f = tmpfile();
+    ASSERT_NE(f, nullptr);
+    {
+        SATSolver s;
+        s.set_frat(f);
+        s.new_vars(3);
+        s.add_clause(str_to_cl("1, 2"));
+        s.add_clause(str_to_cl("-1, 2"));
+        s.add_clause(str_to_cl("1, -2"));
+        s.add_clause(str_to_cl("-1, -2"));
+        EXPECT_EQ(s.solve(), l_False);
+    }
+    const long len = ftell(f);
+    EXPECT_GT(len, 0);
+    rewind(f);
+    std::string proof(len, 0);
+    ASSERT_EQ(fread(&proof[0], 1, len, f), (size_t)len);
+    fclose(f);
+    EXPECT_NE(proof.find("o "), std::string::npos);
+}
+
 TEST(error_throw, toomany_vars)
 {
     SATSolver s;
@@ -1373,6 +1400,670 @@ TEST(xor_recovery, DISABLED_find_xor_renumber)
 }
 
 
+TEST(clause_group, enable_disable_drop)
+{
+    SATSolver s;
+    s.new_vars(2);
+    s.add_clause(str_to_cl("1, 2"));
+    const uint32_t g1 = s.new_clause_group();
+    const uint32_t g2 = s.new_clause_group();
+    s.add_clause_to_group(g1, str_to_cl("-1"));
+    s.add_clause_to_group(g2, str_to_cl("-2"));
+
+    EXPECT_EQ(s.solve(), l_False);
+    EXPECT_TRUE(s.okay());
+    EXPECT_EQ(s.get_conflict().size(), 0U);
+
+    vector<Lit> assumps = str_to_cl("1");
+    s.set_clause_group_enabled(g1, false);
+    EXPECT_EQ(s.solve(&assumps), l_True);
+    EXPECT_EQ(s.get_model()[1], l_False);
+
+    s.set_clause_group_enabled(g1, true);
+    EXPECT_EQ(s.solve(&assumps), l_False);
+    EXPECT_EQ(s.get_conflict(), str_to_cl("-1"));
+
+    s.drop_clause_group(g2);
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_model()[0], l_False);
+    EXPECT_EQ(s.get_model()[1], l_True);
+}
+
+// Allows at most one of the observed variables to be TRUE
+struct AtMostOneProp : public ExternalPropagator {
+    vector<Lit> trail;
+    vector<size_t> trail_lim;
+    vector<Lit> to_prop;
+    uint32_t num_reasons = 0;
+
+    void notify_assignment(const vector<Lit>& lits) override {
+        for(const Lit l: lits) trail.push_back(l);
+    }
+    void notify_new_decision_level() override { trail_lim.push_back(trail.size()); }
+    void notify_backtrack(uint32_t new_level) override {
+        trail.resize(trail_lim[new_level]);
+        trail_lim.resize(new_level);
+    }
+    Lit true_lit() const {
+        for(const Lit l: trail) if (!l.sign()) return l;
+        return lit_Undef;
+    }
+    Lit propagate() override {
+        const Lit t = true_lit();
+        if (t == lit_Undef) return lit_Undef;
+        for(const Lit l: trail) if (l.var() != t.var() && !l.sign()) return Lit(l.var(), true);
+        for(uint32_t v: vars) {
+            bool set = false;
+            for(const Lit l: trail) if (l.var() == v) set = true;
+            if (!set) return Lit(v, true);
+        }
+        return lit_Undef;
+    }
+    void add_reason_clause(Lit propagated, vector<Lit>& reason) override {
+        num_reasons++;
+        reason.push_back(propagated);
+        reason.push_back(~true_lit());
+    }
+    vector<uint32_t> vars;
+};
+
+TEST(ext_propagator, at_most_one_unsat)
+{
+    SATSolver s;
+    s.new_vars(4);
+    AtMostOneProp prop;
+    prop.vars = {0, 1, 2, 3};
+    s.connect_propagator(&prop);
+    for(uint32_t v: prop.vars) s.add_observed_var(v);
+
+    //at least two of them
+    s.add_clause(str_to_cl("1, 2, 3"));
+    s.add_clause(str_to_cl("1, 2, 4"));
+    s.add_clause(str_to_cl("1, 3, 4"));
+    s.add_clause(str_to_cl("2, 3, 4"));
+    EXPECT_EQ(s.solve(), l_False);
+    EXPECT_GT(prop.num_reasons, 0U);
+}
+
+TEST(ext_propagator, at_most_one_sat)
+{
+    SATSolver s;
+    s.new_vars(4);
+    AtMostOneProp prop;
+    prop.vars = {0, 1, 2, 3};
+    s.connect_propagator(&prop);
+    for(uint32_t v: prop.vars) s.add_observed_var(v);
+
+    s.add_clause(str_to_cl("1, 2, 3, 4"));
+    s.add_clause(str_to_cl("-1"));
+    EXPECT_EQ(s.solve(), l_True);
+    uint32_t num_true = 0;
+    for(uint32_t v: prop.vars) num_true += s.get_model()[v] == l_True;
+    EXPECT_EQ(num_true, 1U);
+}
+
+// Only checks complete models: variables 1 and 2 must differ
+struct DifferProp : public ExternalPropagator {
+    vector<vector<Lit>> pending;
+    uint32_t num_rejected = 0;
+
+    void notify_assignment(const vector<Lit>&) override {}
+    void notify_new_decision_level() override {}
+    void notify_backtrack(uint32_t) override {}
+    void add_reason_clause(Lit, vector<Lit>&) override { assert(false); }
+    bool has_external_clause(vector<Lit>& cl, bool&) override {
+        if (pending.empty()) return false;
+        cl = pending.back();
+        pending.pop_back();
+        return true;
+    }
+    bool check_found_model(const vector<lbool>& model) override {
+        if (model[0] != model[1]) return true;
+        num_rejected++;
+        pending.push_back(str_to_cl("1, 2"));
+        pending.push_back(str_to_cl("-1, -2"));
+        return false;
+    }
+};
+
+TEST(ext_propagator, check_found_model)
+{
+    SATSolver s;
+    s.new_vars(3);
+    DifferProp prop;
+    s.connect_propagator(&prop);
+    s.add_observed_var(0);
+    s.add_observed_var(1);
+
+    s.add_clause(str_to_cl("-1, 3"));
+    s.add_clause(str_to_cl("-2, 3"));
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_NE(s.get_model()[0], s.get_model()[1]);
+
+    s.add_clause(str_to_cl("-3"));
+    EXPECT_EQ(s.solve(), l_False);
+}
+
+// Observed variables fixed at level 0 used to be renumbered beyond nVars()
+TEST(ext_propagator, observed_vars_survive_renumbering)
+{
+    SATSolver s;
+    s.new_vars(3000);
+    AtMostOneProp prop;
+    prop.vars = {0, 1, 2, 3, 4};
+    s.connect_propagator(&prop);
+    for(uint32_t v: prop.vars) s.add_observed_var(v);
+
+    std::mt19937 mt(9);
+    for(const auto& cl: random_3sat(mt, 1500, 4000, 1500)) s.add_clause(cl);
+    for(uint32_t v = 0; v < 1500; v++) s.add_clause(vector<Lit>{Lit(v, true)});
+    const string strategy = "must-renumber";
+    EXPECT_NE(s.simplify(nullptr, &strategy), l_False);
+    EXPECT_EQ(s.solve(), l_True);
+    for(uint32_t v: prop.vars) {
+        EXPECT_EQ(s.get_model()[v], l_False);
+        EXPECT_NE(std::find(prop.trail.begin(), prop.trail.end(), Lit(v, true)), prop.trail.end());
+    }
+}
+
+// Model rejection clauses handed over as forgettable end up redundant
+TEST(ext_propagator, forgettable_clauses_are_redundant)
+{
+    struct ForgetProp : public DifferProp {
+        bool has_external_clause(vector<Lit>& cl, bool& forgettable) override {
+            forgettable = true;
+            return DifferProp::has_external_clause(cl, forgettable);
+        }
+    };
+    SATSolver s;
+    s.new_vars(3);
+    ForgetProp prop;
+    s.connect_propagator(&prop);
+    s.add_observed_var(0);
+    s.add_observed_var(1);
+
+    s.add_clause(str_to_cl("-1, 3"));
+    s.add_clause(str_to_cl("-2, 3"));
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_NE(s.get_model()[0], s.get_model()[1]);
+    uint32_t irred = 0;
+    s.start_getting_constraints(false);
+    vector<Lit> lits;
+    bool is_xor, rhs;
+    while(s.get_next_constraint(lits, is_xor, rhs)) irred++;
+    s.end_getting_constraints();
+    EXPECT_EQ(irred, 2U);
+}
+
+// Misuse is reported to the caller instead of aborting
+TEST(ext_propagator, misuse_throws)
+{
+    struct UnobservedProp : public AtMostOneProp {
+        Lit propagate() override { return Lit(3, false); }
+    };
+    SATSolver s;
+    s.new_vars(4);
+    UnobservedProp prop;
+    prop.vars = {0, 1};
+    s.connect_propagator(&prop);
+    for(uint32_t v: prop.vars) s.add_observed_var(v);
+
+    s.add_clause(str_to_cl("1, 2, 3"));
+    s.add_clause(str_to_cl("-1, -2, 4"));
+    EXPECT_THROW(s.solve(), std::runtime_error);
+}
+
+TEST(binary_cnf, dump_and_read)
+{
+    SATSolver s;
+    s.new_vars(40);
+    s.add_clause(str_to_cl("1, -2, 3"));
+    s.add_clause(str_to_cl("-1, 40"));
+    s.add_clause(str_to_cl("-40, 5, -6, 7"));
+    s.add_xor_clause(vector<unsigned>{4, 5, 9}, true);
+    s.set_sampl_vars(vector<uint32_t>{0, 1, 39});
+
+    const char* fname = "basic_test_dump.bcnf";
+    s.open_file_and_dump_irred_clauses_binary(fname);
+    FILE* f = fopen(fname, "rb");
+    ASSERT_NE(f, nullptr);
+    vector<char> data(1U << 16);
+    data.resize(fread(data.data(), 1, data.size(), f));
+    fclose(f);
+    std::remove(fname);
+
+    SATSolver s2;
+    BinaryCnfReader<SATSolver> reader(&s2);
+    ASSERT_TRUE(reader.parse(data.data(), data.size()));
+    EXPECT_EQ(s2.nVars(), 40u);
+    EXPECT_EQ(s2.get_sampl_vars(), (vector<uint32_t>{0, 1, 39}));
+
+    s2.add_clause(str_to_cl("1, 40, -3"));
+    s2.add_clause(str_to_cl("2"));
+    s2.add_clause(str_to_cl("-6"));
+    s2.add_clause(str_to_cl("-7"));
+    s2.add_clause(str_to_cl("-1"));
+    EXPECT_EQ(s2.solve(), l_True);
+    EXPECT_EQ(s2.get_model()[2], l_True);
+
+    const bool x = (s2.get_model()[4] == l_True)
+        ^ (s2.get_model()[5] == l_True)
+        ^ (s2.get_model()[9] == l_True);
+    EXPECT_TRUE(x);
+}
+
+TEST(binary_cnf, truncated)
+{
+    std::string data(reinterpret_cast<const char*>(bcnf_magic), 8);
+    data.append(32, '\0');
+    data += "C";
+    SATSolver s;
+    BinaryCnfReader<SATSolver> reader(&s);
+    EXPECT_FALSE(reader.parse(data.data(), data.size()));
+}
+
+//The header counts are checked against the contents before the variable
+//count is used, a file cannot make the reader allocate at will
+TEST(binary_cnf, header_counts_are_hints)
+{
+    FILE* f = tmpfile();
+    ASSERT_NE(f, nullptr);
+    BinaryCnfWriter writer(f);
+    writer.set_num_vars(50);
+    writer.add_clause(str_to_cl("1, -2, 3"));
+    writer.add_clause(str_to_cl("-3, 4"));
+    writer.add_xor_clause(vector<uint32_t>{0, 4}, true);
+    ASSERT_TRUE(writer.finish());
+    vector<char> data(1U << 10);
+    rewind(f);
+    data.resize(fread(data.data(), 1, data.size(), f));
+    fclose(f);
+
+    auto set_count = [](vector<char> d, const int which, const uint64_t val) {
+        for(int j = 0; j < 8; j++) d[8 + which*8 + j] = (char)((val >> (8*j)) & 0xff);
+        return d;
+    };
+    auto read = [](const vector<char>& d, const bool strict, uint32_t& num_vars) {
+        SATSolver s;
+        BinaryCnfReader<SATSolver> reader(&s);
+        const bool ret = reader.parse(d.data(), d.size(), 0, strict);
+        num_vars = s.nVars();
+        return ret;
+    };
+    uint32_t num_vars;
+
+    //Unused variables come from the header
+    EXPECT_TRUE(read(data, true, num_vars));
+    EXPECT_EQ(num_vars, 50u);
+
+    //Counts that don't match: the variable count is ignored as well
+    const vector<char> wrong = set_count(set_count(data, 0, 1U << 27), 1, 3);
+    EXPECT_TRUE(read(wrong, false, num_vars));
+    EXPECT_EQ(num_vars, 5u);
+    EXPECT_FALSE(read(wrong, true, num_vars));
+
+    //Variables beyond the header's count
+    const vector<char> few = set_count(data, 0, 2);
+    EXPECT_TRUE(read(few, false, num_vars));
+    EXPECT_EQ(num_vars, 5u);
+    EXPECT_FALSE(read(few, true, num_vars));
+}
+
+//Every record is shifted by the offset and range checked, not only clauses
+TEST(binary_cnf, offset_applies_to_all_records)
+{
+    auto write = [](const std::function<void(BinaryCnfWriter&)>& f) {
+        FILE* fp = tmpfile();
+        BinaryCnfWriter writer(fp);
+        f(writer);
+        writer.finish();
+        vector<char> data(1U << 10);
+        rewind(fp);
+        data.resize(fread(data.data(), 1, data.size(), fp));
+        fclose(fp);
+        return data;
+    };
+
+    const vector<char> sampl = write([](BinaryCnfWriter& w) {
+        w.add_clause(str_to_cl("1, -2"));
+        w.set_sampl_vars(vector<uint32_t>{0, 4});
+    });
+    SATSolver s;
+    s.new_vars(10);
+    BinaryCnfReader<SATSolver> reader(&s);
+    ASSERT_TRUE(reader.parse(sampl.data(), sampl.size(), 10));
+    EXPECT_EQ(s.nVars(), 15u);
+    EXPECT_EQ(s.get_sampl_vars(), (vector<uint32_t>{10, 14}));
+
+    const vector<char> weight = write([](BinaryCnfWriter& w) {
+        w.set_lit_weight(Lit((1U << 28) - 5, false), 0.5);
+    });
+    SATSolver s2;
+    BinaryCnfReader<SATSolver> reader2(&s2);
+    EXPECT_FALSE(reader2.parse(weight.data(), weight.size(), 10));
+    EXPECT_EQ(s2.nVars(), 0u);
+}
+
+TEST(reconstruction, serialize_and_extend)
+{
+    vector<vector<Lit>> cls;
+    for(uint32_t i = 0; i < 29; i++) {
+        cls.push_back(vector<Lit>{Lit(i, true), Lit(i+1, false)});
+        cls.push_back(vector<Lit>{Lit(i, false), Lit((i+7)%30, false), Lit((i+13)%30, true)});
+    }
+    cls.push_back(vector<Lit>{Lit(3, false), Lit(20, false)});
+    SATSolver s;
+    s.new_vars(30);
+    for(const auto& cl: cls) s.add_clause(cl);
+
+    const std::string sched = "occ-bve, scc-vrepl, must-renumber";
+    EXPECT_EQ(s.simplify(nullptr, &sched), l_Undef);
+    const uint32_t nvars = s.simplified_nvars();
+    EXPECT_LT(nvars, 30u);
+
+    SATSolver s2;
+    s2.new_vars(nvars);
+    s.start_getting_constraints(false, true);
+    vector<Lit> lits; bool is_xor; bool rhs;
+    while (s.get_next_constraint(lits, is_xor, rhs)) {
+        if (is_xor) {
+            vector<uint32_t> vars;
+            for(const Lit l: lits) vars.push_back(l.var());
+            s2.add_xor_clause(vars, rhs);
+        } else {
+            s2.add_clause(lits);
+        }
+    }
+    s.end_getting_constraints();
+    ASSERT_EQ(s2.solve(), l_True);
+
+    std::string data = s.serialize_solution_reconstruction_data();
+    void* setup = SATSolver::create_extend_solution_setup(data);
+    ASSERT_NE(setup, nullptr);
+    const auto ret = SATSolver::extend_solution(setup, s2.get_model());
+    SATSolver::delete_extend_solution_setup(setup);
+    EXPECT_EQ(ret.first, l_True);
+    ASSERT_EQ(ret.second.size(), 30u);
+    EXPECT_TRUE(check_model_satisfies(cls, ret.second));
+
+    std::string bad = data.substr(0, data.size()/2);
+    EXPECT_EQ(SATSolver::create_extend_solution_setup(bad), nullptr);
+}
+
+TEST(checkpoint, save_and_load)
+{
+    std::mt19937 mt(7);
+    const vector<vector<Lit>> cls = random_3sat(mt, 170, 700);
+
+    SATSolver s;
+    s.new_vars(170);
+    for(const auto& cl: cls) s.add_clause(cl);
+    s.add_xor_clause(vector<unsigned>{4, 5, 9}, true);
+    s.set_max_confl(200);
+    s.solve();
+
+    const char* fname = "basic_test_checkpoint";
+    ASSERT_TRUE(s.save_state(fname));
+
+    SATSolver s2;
+    ASSERT_TRUE(s2.load_state(fname));
+    std::remove(fname);
+    EXPECT_EQ(s2.nVars(), 170u);
+    const lbool ret = s2.solve();
+
+    SATSolver s3;
+    s3.new_vars(170);
+    for(const auto& cl: cls) s3.add_clause(cl);
+    s3.add_xor_clause(vector<unsigned>{4, 5, 9}, true);
+    ASSERT_EQ(ret, s3.solve());
+    if (ret == l_True) {
+        EXPECT_TRUE(check_model_satisfies(cls, s2.get_model()));
+        const auto& m = s2.get_model();
+        EXPECT_TRUE((m[4] == l_True) ^ (m[5] == l_True) ^ (m[9] == l_True));
+    }
+
+    SATSolver s4;
+    EXPECT_FALSE(s4.load_state("basic_test_no_such_checkpoint"));
+}
+
+static const PhaseStats* find_phase(const vector<PhaseStats>& stats, const std::string& name)
+{
+    for(const auto& p: stats) if (p.name == name) return &p;
+    return nullptr;
+}
+
+TEST(telemetry, phases_recorded)
+{
+    SATSolver s;
+    s.new_vars(100);
+    std::mt19937 mt(3);
+    for(const auto& cl: random_3sat(mt, 100, 420)) s.add_clause(cl);
+    const std::string sched = "occ-bve, scc-vrepl";
+    s.simplify(nullptr, &sched);
+    s.solve();
+
+    bool found_search = false;
+    bool found_bve = false;
+    for(const auto& p: s.get_phase_stats()) {
+        EXPECT_GT(p.calls, 0u);
+        EXPECT_GE(p.wall_time, 0);
+        if (p.name == "search") {
+            found_search = true;
+            EXPECT_GE(p.conflicts, 0u);
+        }
+        if (p.name == "occ-bve") found_bve = true;
+    }
+    EXPECT_TRUE(found_search);
+    EXPECT_TRUE(found_bve);
+
+    const std::string json = s.get_phase_stats_json();
+    EXPECT_NE(json.find("\"name\": \"search\""), std::string::npos);
+}
+
+TEST(telemetry, gauss_matrices_recorded)
+{
+    SolverConf conf;
+    conf.gaussconf.autodisable = false;
+    SATSolver s(&conf);
+    s.new_vars(60);
+    std::mt19937 mt(5);
+    for(uint32_t i = 0; i < 50; i++) {
+        vector<uint32_t> vars;
+        for(uint32_t j = 0; j < 4; j++) vars.push_back(mt() % 60);
+        std::sort(vars.begin(), vars.end());
+        vars.erase(std::unique(vars.begin(), vars.end()), vars.end());
+        s.add_xor_clause(vars, mt() & 1);
+    }
+    s.solve();
+
+    const vector<PhaseStats> stats = s.get_phase_stats();
+    const PhaseStats* gauss = find_phase(stats, "gauss");
+    const PhaseStats* mat = find_phase(stats, "gauss-0");
+    ASSERT_NE(gauss, nullptr);
+    ASSERT_NE(mat, nullptr);
+    EXPECT_GT(mat->calls, 0u);
+    EXPECT_GE(mat->cpu_time, 0);
+    uint64_t props = 0;
+    for(const auto& p: stats) if (p.name.rfind("gauss-", 0) == 0) props += p.propagations;
+    EXPECT_EQ(props, gauss->propagations);
+}
+
+// Counters may not be available (e.g. in a VM), the solver must then carry
+// on with them switched off
+TEST(telemetry, hw_counters_optional)
+{
+    SolverConf conf;
+    conf.hw_counters = 1;
+    SATSolver s(&conf);
+    s.new_vars(100);
+    std::mt19937 mt(4);
+    for(const auto& cl: random_3sat(mt, 100, 420)) s.add_clause(cl);
+    testing::internal::CaptureStdout();
+    s.solve();
+    const std::string out = testing::internal::GetCapturedStdout();
+    const bool warned = out.find("WARNING: could not open hardware performance counters")
+        != std::string::npos;
+
+    const PhaseStats* search = nullptr;
+    const PhaseStats* prop = nullptr;
+    const PhaseStats* analyze = nullptr;
+    const vector<PhaseStats> stats = s.get_phase_stats();
+    for(const auto& p: stats) {
+        if (p.name == "search") search = &p;
+        if (p.name == "propagate-sampled") prop = &p;
+        if (p.name == "analyze-sampled") analyze = &p;
+
+        //Either all four counters were read or none of them
+        if (p.instructions == 0) {
+            EXPECT_EQ(p.cycles, 0u);
+            EXPECT_EQ(p.cache_misses, 0u);
+            EXPECT_EQ(p.branch_misses, 0u);
+        } else {
+            EXPECT_GT(p.cycles, 0u);
+            EXPECT_LE(p.cache_misses, p.instructions);
+            EXPECT_LE(p.branch_misses, p.instructions);
+        }
+    }
+    ASSERT_NE(search, nullptr);
+    EXPECT_GT(search->conflicts, 0u);
+
+    if (search->instructions == 0) {
+        //Fell back: said so even at verbosity 0, and sampled nothing
+        EXPECT_TRUE(warned);
+        EXPECT_EQ(prop, nullptr);
+        EXPECT_EQ(analyze, nullptr);
+    } else {
+        //The samples are taken inside search, and there was a conflict
+        EXPECT_FALSE(warned);
+        ASSERT_NE(prop, nullptr);
+        ASSERT_NE(analyze, nullptr);
+        EXPECT_GT(prop->instructions, 0u);
+        EXPECT_GT(analyze->instructions, 0u);
+        EXPECT_LE(prop->instructions, search->instructions);
+        EXPECT_LE(analyze->instructions, search->instructions);
+        EXPECT_LE(analyze->calls, search->conflicts/64 + 1);
+    }
+    EXPECT_NE(s.get_phase_stats_json().find("\"cache_misses\": "), std::string::npos);
+}
+
+TEST(trace, spans_written)
+{
+    const char* fname = "basic_test_trace";
+    {
+        SATSolver s;
+        ASSERT_TRUE(s.set_trace_file(fname));
+        s.set_num_threads(2);
+        s.new_vars(100);
+        std::mt19937 mt(5);
+        for(const auto& cl: random_3sat(mt, 100, 420)) s.add_clause(cl);
+        const std::string sched = "occ-bve, scc-vrepl";
+        s.simplify(nullptr, &sched);
+        s.solve();
+    }
+
+    std::ifstream f(fname);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    std::remove(fname);
+    const std::string trace = ss.str();
+    EXPECT_EQ(trace.substr(0, 1), "[");
+    EXPECT_NE(trace.find("\"name\": \"search\", \"ph\": \"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\": \"occ-bve\""), std::string::npos);
+    EXPECT_NE(trace.find("\"tid\": 1"), std::string::npos);
+}
+
+TEST(occ, incremental_runs_keep_model_correct)
+{
+    SolverConf conf;
+    conf.occ_incremental = 1;
+    SATSolver s(&conf);
+    s.new_vars(200);
+    std::mt19937 mt(7);
+    vector<vector<Lit>> cls;
+    auto add_random = [&](uint32_t num) {
+        for(const auto& cl: random_3sat(mt, 200, num)) {
+            s.add_clause(cl);
+            cls.push_back(cl);
+        }
+    };
+    const std::string sched = "occ-backw-sub-str, occ-bve";
+    add_random(600);
+    s.simplify(nullptr, &sched);
+    s.simplify(nullptr, &sched);
+    add_random(100);
+    s.simplify(nullptr, &sched);
+
+    //Only BVE is restricted, subsumption always has new learnts to look at
+    const vector<PhaseStats> stats = s.get_phase_stats();
+    const PhaseStats* sub = find_phase(stats, "occ-backw-sub-str");
+    ASSERT_NE(sub, nullptr);
+    EXPECT_EQ(sub->calls, 3u);
+
+    ASSERT_EQ(s.solve(), l_True);
+    EXPECT_TRUE(check_model_satisfies(cls, s.get_model()));
+}
+
+TEST(occ, incremental_bve_skipped_when_nothing_changed)
+{
+    SolverConf conf;
+    conf.occ_incremental = 1;
+    SATSolver s(&conf);
+    s.new_vars(200);
+    std::mt19937 mt(7);
+    for(const auto& cl: random_3sat(mt, 200, 600)) s.add_clause(cl);
+    const std::string sched = "occ-bve";
+    s.simplify(nullptr, &sched);
+    s.simplify(nullptr, &sched);
+
+    const vector<PhaseStats> stats = s.get_phase_stats();
+    const PhaseStats* bve = find_phase(stats, "occ-bve");
+    ASSERT_NE(bve, nullptr);
+    EXPECT_EQ(bve->calls, 1u);
+}
+
+//Vars under assumptions can't be eliminated. Once the assumptions are gone
+//they must be tried again, although none of their clauses changed.
+TEST(occ, incremental_bve_retries_vars_no_longer_assumed)
+{
+    auto num_elimed = [](const int incremental) {
+        SolverConf conf;
+        conf.occ_incremental = incremental;
+        SATSolver s(&conf);
+        s.new_vars(50);
+        std::mt19937 mt(2);
+        for(const auto& cl: random_3sat(mt, 50, 100)) s.add_clause(cl);
+        vector<Lit> assumps;
+        for(uint32_t v = 0; v < 25; v++) assumps.push_back(Lit(v, false));
+        const std::string sched = "occ-bve";
+        s.simplify(&assumps, &sched);
+        s.simplify(nullptr, &sched);
+        const vector<PhaseStats> stats = s.get_phase_stats();
+        const PhaseStats* bve = find_phase(stats, "occ-bve");
+        EXPECT_NE(bve, nullptr);
+        return bve ? bve->vars_removed : 0;
+    };
+    const int64_t full = num_elimed(0);
+    EXPECT_GT(full, 0);
+    EXPECT_EQ(num_elimed(1), full);
+}
+
+//The RSS of the process is always over this budget, even after the relief
+TEST(mem_budget, over_budget_returns_undef)
+{
+    SATSolver s;
+    s.new_vars(300);
+    std::mt19937 mt(7);
+    for(const auto& cl: random_3sat(mt, 300, 1280)) s.add_clause(cl);
+    s.set_mem_budget(512*1024);
+    EXPECT_EQ(s.solve(), l_Undef);
+    bool relief = false;
+    for(const auto& p: s.get_phase_stats()) relief |= p.name == "mem-budget-relief" && p.calls > 0;
+    EXPECT_TRUE(relief);
+
+    s.set_mem_budget(0);
+    EXPECT_NE(s.solve(), l_Undef);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
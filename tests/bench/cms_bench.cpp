@@ -0,0 +1,454 @@
+/******************************************
+Copyright (C) 2009-2024 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+// Microbenchmarks of the solver's hot kernels, build with
+// -DENABLE_BENCHMARKS=ON. Fixtures are fixed-seed random 3-SAT instances and
+// every .cnf file in CMS_BENCH_CNF_DIR (default: tests/cnf-files)
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "src/solver.h"
+#include "src/solverconf.h"
+#include "src/clauseallocator.h"
+#include "src/packedmatrix.h"
+#include "src/heap.h"
+#include "src/vmtf.h"
+#include "src/dimacsparser.h"
+#include "src/hwcounters.h"
+#include "cryptominisat5/cryptominisat.h"
+
+using namespace CMSat;
+using std::vector;
+using std::string;
+
+namespace {
+
+struct Cnf {
+    uint32_t num_vars = 0;
+    vector<vector<Lit>> cls;
+    string text;
+};
+
+// Random 3-SAT near the threshold, its propagation and conflict profile is
+// close enough to industrial instances for the kernels measured here and it
+// can be made arbitrarily large. Fixed seed, so runs are comparable.
+Cnf random_3sat(const uint32_t num_vars, const double ratio = 4.2)
+{
+    Cnf cnf;
+    cnf.num_vars = num_vars;
+    std::mt19937 mt(num_vars);
+    const uint32_t num_cls = (uint32_t)(num_vars*ratio);
+    std::stringstream ss;
+    ss << "p cnf " << num_vars << " " << num_cls << "\n";
+    for(uint32_t i = 0; i < num_cls; i++) {
+        vector<Lit> cl;
+        while(cl.size() < 3) {
+            const Lit l(mt()%num_vars, mt()%2);
+            bool dup = false;
+            for(const Lit x: cl) dup |= x.var() == l.var();
+            if (!dup) cl.push_back(l);
+        }
+        for(const Lit l: cl) ss << (l.sign() ? "-" : "") << l.var()+1 << " ";
+        ss << "0\n";
+        cnf.cls.push_back(cl);
+    }
+    cnf.text = ss.str();
+    return cnf;
+}
+
+// Clauses over a sliding window of variables, like the locality of many
+// industrial encodings, with the variable numbers shuffled afterwards so that
+// the input numbering has none of it. Renumbering has to recover it.
+Cnf windowed_3sat(const uint32_t num_vars, const uint32_t window = 40, const double ratio = 4.0)
+{
+    Cnf cnf;
+    cnf.num_vars = num_vars;
+    std::mt19937 mt(num_vars+1);
+    vector<uint32_t> perm(num_vars);
+    for(uint32_t i = 0; i < num_vars; i++) perm[i] = i;
+    std::shuffle(perm.begin(), perm.end(), mt);
+    const uint32_t num_cls = (uint32_t)(num_vars*ratio);
+    std::stringstream ss;
+    ss << "p cnf " << num_vars << " " << num_cls << "\n";
+    for(uint32_t i = 0; i < num_cls; i++) {
+        const uint32_t base = mt()%(num_vars-window);
+        vector<Lit> cl;
+        while(cl.size() < 3) {
+            const Lit l(perm[base + mt()%window], mt()%2);
+            bool dup = false;
+            for(const Lit x: cl) dup |= x.var() == l.var();
+            if (!dup) cl.push_back(l);
+        }
+        for(const Lit l: cl) ss << (l.sign() ? "-" : "") << l.var()+1 << " ";
+        ss << "0\n";
+        cnf.cls.push_back(cl);
+    }
+    cnf.text = ss.str();
+    return cnf;
+}
+
+// Plain CNF only, XOR and comment lines are skipped
+Cnf load_cnf(const string& fname)
+{
+    Cnf cnf;
+    std::ifstream f(fname);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    cnf.text = ss.str();
+
+    std::istringstream in(cnf.text);
+    string line;
+    while(std::getline(in, line)) {
+        if (line.empty() || line[0] == 'c' || line[0] == 'p' || line[0] == 'x') continue;
+        std::istringstream ls(line);
+        vector<Lit> cl;
+        int x;
+        while(ls >> x && x != 0) {
+            cl.push_back(Lit(std::abs(x)-1, x < 0));
+            cnf.num_vars = std::max<uint32_t>(cnf.num_vars, std::abs(x));
+        }
+        cnf.cls.push_back(cl);
+    }
+    return cnf;
+}
+
+// Opens up the internals the kernels need
+struct BenchSolver : public Solver {
+    BenchSolver(const SolverConf* _conf, std::atomic<bool>* _must_interrupt) :
+        Solver(_conf, _must_interrupt)
+    {}
+    using Solver::propagate_any_order;
+    using Solver::analyze_conflict;
+    using Solver::learnt_clause;
+};
+
+struct Fixture {
+    explicit Fixture(const Cnf& cnf) {
+        conf.verbosity = 0;
+        conf.doRenumberVars = false;
+        must_inter.store(false);
+        s = new BenchSolver(&conf, &must_inter);
+        s->new_external_vars(cnf.num_vars);
+        for(const auto& cl: cnf.cls) s->add_clause_outside(cl);
+        order.resize(cnf.num_vars);
+        for(uint32_t i = 0; i < cnf.num_vars; i++) order[i] = Lit(i, i%2);
+        std::shuffle(order.begin(), order.end(), std::mt19937(1));
+    }
+    ~Fixture() { delete s; }
+
+    // Renumbers in the given order (see SolverConf::renumber_order) and maps
+    // the decision order along, so the same decisions are taken either way
+    void renumber(const int renumber_order) {
+        s->conf.renumber_order = renumber_order;
+        s->renumber_variables(true);
+        for(auto& l: order) l = s->map_outer_to_inter(l);
+    }
+
+    Fixture(const Fixture&) = delete;
+    Fixture& operator=(const Fixture&) = delete;
+
+    // Decides literals in a fixed order until a conflict or everything is
+    // set. Returns the conflict, if any
+    PropBy decide_until_conflict(size_t& at) {
+        PropBy confl;
+        while(confl.isnullptr()) {
+            while(at < order.size() && s->value(order[at]) != l_Undef) at++;
+            if (at == order.size()) break;
+            s->new_decision_level();
+            s->enqueue<false>(order[at]);
+            confl = s->propagate_any_order<false>();
+        }
+        return confl;
+    }
+
+    SolverConf conf;
+    std::atomic<bool> must_inter;
+    BenchSolver* s;
+    vector<Lit> order;
+};
+
+string cnf_dir()
+{
+    const char* dir = std::getenv("CMS_BENCH_CNF_DIR");
+    return dir ? dir : CMS_BENCH_CNF_DIR;
+}
+
+//////////////////
+// Propagation
+//////////////////
+
+void propagate_fixture(benchmark::State& state, Fixture& fx)
+{
+    uint64_t props = 0;
+    size_t at = 0;
+    HwCounters hw;
+    hw.open();
+    const HwCounts hw_before = hw.read();
+    for (auto _ : state) {
+        const size_t before = fx.s->nAssigns();
+        PropBy confl = fx.decide_until_conflict(at);
+        props += fx.s->nAssigns() - before;
+        benchmark::DoNotOptimize(confl);
+        fx.s->cancelUntil(0);
+        if (at == fx.order.size()) at = 0;
+        else at++;
+    }
+    state.counters["props"] = benchmark::Counter((double)props, benchmark::Counter::kIsRate);
+    if (hw.enabled() && props > 0) {
+        const HwCounts hw_after = hw.read();
+        state.counters["cache-miss/prop"] =
+            (double)(hw_after.cache_misses - hw_before.cache_misses)/(double)props;
+    }
+}
+
+void propagate(benchmark::State& state, const Cnf& cnf)
+{
+    Fixture fx(cnf);
+    propagate_fixture(state, fx);
+}
+
+// Same decisions as BM_propagate, after renumbering in the given order
+void propagate_renumbered(benchmark::State& state, const Cnf& cnf, const int renumber_order)
+{
+    Fixture fx(cnf);
+    fx.renumber(renumber_order);
+    propagate_fixture(state, fx);
+}
+
+//////////////////
+// Conflict analysis, timed manually so that propagation is not included
+//////////////////
+
+void analyze(benchmark::State& state, const Cnf& cnf)
+{
+    Fixture fx(cnf);
+    size_t at = 0;
+    uint64_t lits = 0;
+    for (auto _ : state) {
+        PropBy confl;
+        uint32_t wraps = 0;
+        while(confl.isnullptr() && wraps < 2) {
+            fx.s->cancelUntil(0);
+            if (at >= fx.order.size()) {
+                at = 0;
+                wraps++;
+            }
+            confl = fx.decide_until_conflict(at);
+            at++;
+        }
+        if (confl.isnullptr()) {
+            state.SkipWithError("no conflict with this decision order");
+            break;
+        }
+        uint32_t btlevel, glue, glue_before, size_before;
+        const auto start = std::chrono::steady_clock::now();
+        fx.s->analyze_conflict<false>(confl, btlevel, glue, glue_before, size_before);
+        const auto end = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+        lits += fx.s->learnt_clause.size();
+        fx.s->cancelUntil(0);
+    }
+    state.counters["lits/learnt"] = benchmark::Counter((double)lits/(double)state.iterations());
+}
+
+//////////////////
+// Clause arena
+//////////////////
+
+void consolidate(benchmark::State& state, const Cnf& cnf, const bool by_tier)
+{
+    Fixture fx(cnf);
+    fx.s->conf.consolidate_by_tier = by_tier;
+    for (auto _ : state) {
+        fx.s->cl_alloc.consolidate(fx.s, true, true);
+    }
+    state.counters["cls"] = benchmark::Counter(
+        (double)fx.s->longIrredCls.size()*state.iterations(), benchmark::Counter::kIsRate);
+}
+
+//////////////////
+// Occurrence-based BVE, timed manually so that setup is not included
+//////////////////
+
+void bve(benchmark::State& state, const Cnf& cnf)
+{
+    const string strategy = "occ-bve";
+    for (auto _ : state) {
+        SATSolver s;
+        s.new_vars(cnf.num_vars);
+        for(const auto& cl: cnf.cls) s.add_clause(cl);
+        const auto start = std::chrono::steady_clock::now();
+        s.simplify(nullptr, &strategy);
+        const auto end = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+    }
+}
+
+//////////////////
+// DIMACS parsing, from memory so that I/O is not included
+//////////////////
+
+void parse(benchmark::State& state, const Cnf& cnf)
+{
+    for (auto _ : state) {
+        SATSolver s;
+        s.set_verbosity(0);
+        DimacsParser<StreamBuffer<MemRange, MEM>, SATSolver> parser(&s, nullptr, 0);
+        const char* start = cnf.text.data();
+        if (!parser.parse_DIMACS_mem(start, start + cnf.text.size(), false)) {
+            state.SkipWithError("parse error");
+        }
+    }
+    state.SetBytesProcessed((int64_t)cnf.text.size()*state.iterations());
+}
+
+//////////////////
+// Gauss-Jordan row XOR
+//////////////////
+
+void BM_packedrow_xor(benchmark::State& state)
+{
+    const uint32_t cols = state.range(0);
+    const uint32_t rows = 64;
+    PackedMatrix mat;
+    mat.resize(rows, cols);
+    std::mt19937 mt(cols);
+    for(uint32_t i = 0; i < rows; i++) {
+        PackedRow r = mat[i];
+        r.setZero();
+        r.rhs() = 0;
+        for(uint32_t c = 0; c < cols; c++) if (mt()%2) r.setBit(c);
+    }
+    uint32_t i = 0;
+    for (auto _ : state) {
+        PackedRow a = mat[i % rows];
+        a ^= mat[(i+1) % rows];
+        benchmark::DoNotOptimize(a.rhs());
+        i++;
+    }
+    state.SetBytesProcessed((int64_t)(cols/8)*state.iterations());
+}
+BENCHMARK(BM_packedrow_xor)->RangeMultiplier(4)->Range(64, 16384);
+
+//////////////////
+// Branching heuristics
+//////////////////
+
+struct ActLt {
+    const vector<double>& act;
+    bool operator()(uint32_t a, uint32_t b) const { return act[a] > act[b]; }
+};
+
+// VSIDS-like: pick the best, bump a few, put them back
+void BM_heap_vsids(benchmark::State& state)
+{
+    const uint32_t n = state.range(0);
+    vector<double> act(n);
+    std::mt19937 mt(n);
+    for(auto& a: act) a = (double)(mt()%1000);
+    Heap<ActLt> heap(ActLt{act});
+    for(uint32_t i = 0; i < n; i++) heap.insert(i);
+    double inc = 1;
+    for (auto _ : state) {
+        const uint32_t v = heap.removeMin();
+        for(uint32_t j = 0; j < 8; j++) {
+            const uint32_t b = mt()%n;
+            act[b] += inc;
+            if (heap.inHeap(b)) heap.decrease(b);
+        }
+        heap.insert(v);
+        inc *= 1.05;
+        if (inc > 1e100) {
+            for(auto& a: act) a *= 1e-100;
+            inc *= 1e-100;
+        }
+    }
+}
+BENCHMARK(BM_heap_vsids)->RangeMultiplier(8)->Range(1024, 1<<20);
+
+// VMTF: move bumped variables to the front of the queue
+void BM_vmtf_bump(benchmark::State& state)
+{
+    const uint32_t n = state.range(0);
+    vector<Link> links(n);
+    Queue queue;
+    for(uint32_t i = 0; i < n; i++) queue.enqueue(links, i);
+    std::mt19937 mt(n);
+    for (auto _ : state) {
+        const uint32_t v = mt()%n;
+        queue.dequeue(links, v);
+        queue.enqueue(links, v);
+    }
+    benchmark::DoNotOptimize(queue.last);
+}
+BENCHMARK(BM_vmtf_bump)->RangeMultiplier(8)->Range(1024, 1<<20);
+
+void register_for(const string& name, const Cnf& cnf)
+{
+    benchmark::RegisterBenchmark(("BM_propagate/" + name).c_str(), propagate, cnf);
+    benchmark::RegisterBenchmark(("BM_propagate_renum/compact/" + name).c_str(), propagate_renumbered, cnf, 0);
+    benchmark::RegisterBenchmark(("BM_propagate_renum/bfs/" + name).c_str(), propagate_renumbered, cnf, 1);
+    benchmark::RegisterBenchmark(("BM_analyze/" + name).c_str(), analyze, cnf)->UseManualTime();
+    benchmark::RegisterBenchmark(("BM_consolidate/" + name).c_str(), consolidate, cnf, false);
+    benchmark::RegisterBenchmark(("BM_consolidate_tier/" + name).c_str(), consolidate, cnf, true);
+    benchmark::RegisterBenchmark(("BM_bve/" + name).c_str(), bve, cnf)->UseManualTime();
+    benchmark::RegisterBenchmark(("BM_parse/" + name).c_str(), parse, cnf);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    for(const uint32_t n: {10000U, 100000U}) {
+        register_for("random3sat-" + std::to_string(n), random_3sat(n));
+        register_for("windowed3sat-" + std::to_string(n), windowed_3sat(n));
+    }
+
+    // Real instances: every plain .cnf file in the corpus directory
+    std::error_code ec;
+    vector<std::filesystem::path> files;
+    for(const auto& e: std::filesystem::directory_iterator(cnf_dir(), ec)) {
+        if (e.path().extension() == ".cnf") files.push_back(e.path());
+    }
+    std::sort(files.begin(), files.end());
+    for(const auto& f: files) {
+        const Cnf cnf = load_cnf(f.string());
+        if (cnf.num_vars == 0) continue;
+        register_for(f.stem().string(), cnf);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -395,6 +395,50 @@ TEST(ipasir_interface, ipasir_val)
     EXPECT_EQ(ipasir_val(s, 8), 8);
 }
 
+struct LearnData {
+    int max_len = 0;
+    int num_learnt = 0;
+    bool too_long = false;
+};
+
+static void learn_cb(void* state, int* clause)
+{
+    LearnData* d = (LearnData*)state;
+    int sz = 0;
+    while(clause[sz] != 0) sz++;
+    if (sz > d->max_len) d->too_long = true;
+    d->num_learnt++;
+}
+
+TEST(ipasir_interface, ipasir_set_learn)
+{
+    //Pigeon hole, 6 pigeons into 5 holes: UNSAT, needs conflicts
+    const int pigeons = 6;
+    const int holes = 5;
+    void* s = ipasir_init();
+    for(int p = 0; p < pigeons; p++) {
+        for(int h = 0; h < holes; h++) ipasir_add(s, p*holes+h+1);
+        ipasir_add(s, 0);
+    }
+    for(int h = 0; h < holes; h++) {
+        for(int p1 = 0; p1 < pigeons; p1++) {
+            for(int p2 = p1+1; p2 < pigeons; p2++) {
+                ipasir_add(s, -(p1*holes+h+1));
+                ipasir_add(s, -(p2*holes+h+1));
+                ipasir_add(s, 0);
+            }
+        }
+    }
+
+    LearnData d;
+    d.max_len = 4;
+    ipasir_set_learn(s, &d, d.max_len, learn_cb);
+    int ret = ipasir_solve(s);
+    EXPECT_EQ(ret, 20);
+    EXPECT_GT(d.num_learnt, 0);
+    EXPECT_FALSE(d.too_long);
+    ipasir_release(s);
+}
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
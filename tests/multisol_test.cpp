@@ -33,6 +33,47 @@ THE SOFTWARE.
 using std::vector;
 using namespace CMSat;
 
+static bool count_model(void* state, const vector<lbool>&)
+{
+    (*(uint32_t*)state)++;
+    return true;
+}
+
+//Same enumeration, done by the library with minimized blocking clauses
+static bool check_enumerate()
+{
+    bool ok = true;
+
+    //All 15 models of "1 2 3 4 0"
+    SATSolver s;
+    s.new_vars(4);
+    s.add_clause(vector<Lit>{Lit(0, false), Lit(1, false), Lit(2, false), Lit(3, false)});
+    uint32_t num = 0;
+    ok &= s.enumerate(&num, count_model, 100) == l_False;
+    ok &= num == 15;
+
+    //Projected onto vars 1 and 2, "-1 2 0" leaves 3 models
+    SATSolver s2;
+    s2.new_vars(4);
+    s2.add_clause(vector<Lit>{Lit(0, false), Lit(1, false), Lit(2, false), Lit(3, false)});
+    s2.add_clause(vector<Lit>{Lit(0, true), Lit(1, false)});
+    vector<uint32_t> proj = {0, 1};
+    num = 0;
+    ok &= s2.enumerate(&num, count_model, 100, &proj) == l_False;
+    ok &= num == 3;
+
+    //Hitting the limit leaves the rest of the models unexplored
+    SATSolver s3;
+    s3.new_vars(4);
+    s3.add_clause(vector<Lit>{Lit(0, false), Lit(1, false), Lit(2, false), Lit(3, false)});
+    num = 0;
+    ok &= s3.enumerate(&num, count_model, 5) == l_True;
+    ok &= num == 5;
+
+    if (!ok) std::cout << "Enumeration returned the wrong models." << std::endl;
+    return ok;
+}
+
 int main()
 {
     SATSolver solver;
@@ -80,5 +121,5 @@ int main()
         }
     }
 
-    return 0;
+    return check_enumerate() ? 0 : -1;
 }
@@ -27,6 +27,7 @@ THE SOFTWARE.
 
 #include "src/solver.h"
 #include "src/sccfinder.h"
+#include "src/varreplacer.h"
 #include "src/solverconf.h"
 using namespace CMSat;
 #include "test_helper.h"
@@ -184,6 +185,35 @@ TEST(scc_test, limit_test2)
     EXPECT_EQ(scc.get_binxors().size(), 0U);
 }
 
+//Cycles closed by binaries added between runs must still be found
+TEST(scc_test, incremental_run_closes_cycle)
+{
+    SolverConf conf;
+
+    std::unique_ptr<std::atomic<bool>> tmp(new std::atomic<bool>(false));
+    Solver s(&conf, tmp.get());
+    s.new_vars(20);
+    for(uint32_t i = 0; i < 5; i++) s.add_clause_outside({Lit(i, true), Lit(i+1, false)});
+    for(uint32_t i = 10; i < 19; i++) s.add_clause_outside({Lit(i, true), Lit(i+1, false)});
+    const std::string sched = "scc-vrepl";
+    const auto num_incremental = [&] {
+        return s.varReplacer->get_scc_finder()->get_stats().incremental;
+    };
+    s.simplify_with_assumptions(nullptr, &sched);
+    EXPECT_EQ(s.get_all_binary_xors().size(), 0U);
+    EXPECT_EQ(num_incremental(), 0U);
+
+    s.add_clause_outside(str_to_cl("-6, 1"));
+    s.simplify_with_assumptions(nullptr, &sched);
+    EXPECT_EQ(s.get_all_binary_xors().size(), 5U);
+    EXPECT_EQ(num_incremental(), 1U);
+
+    s.add_clause_outside(str_to_cl("-20, 11"));
+    s.simplify_with_assumptions(nullptr, &sched);
+    EXPECT_EQ(s.get_all_binary_xors().size(), 14U);
+    EXPECT_EQ(num_incremental(), 2U);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -23,6 +23,8 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <set>
+#include <limits>
+#include <algorithm>
 using std::set;
 
 #include "src/solver.h"
@@ -282,6 +284,233 @@ TEST_F(SolverTest, get_irred_bin_and_long)
     s->end_getting_constraints();
 }
 
+
+static uint64_t phase_calls(const Solver& s, const std::string& name)
+{
+    for(const auto& p: s.get_phase_stats()) if (p.name == name) return p.calls;
+    return 0;
+}
+
+//Close to its share of the budget: the clause database is cut harder and occ
+//is skipped, which keeps the search under the budget until it finishes. The
+//solver's own data of this instance peaks at about 1.3 MB, the budget is far
+//above the RSS so only the share matters
+TEST_F(SolverTest, mem_budget_pressure_degrades_before_stopping)
+{
+    const std::string sched = "occ-bve";
+    std::mt19937 mt(6);
+    const auto cls = random_3sat(mt, 300, 1280);
+
+    std::atomic<bool> ref_inter(false);
+    Solver ref(&conf, &ref_inter);
+    ref.new_vars(300);
+    for(const auto& cl: cls) ref.add_clause_outside(cl);
+    ref.simplify_with_assumptions(nullptr, &sched);
+    const lbool ref_ret = ref.solve_with_assumptions();
+    ASSERT_NE(ref_ret, l_Undef);
+    EXPECT_GT(phase_calls(ref, "occ-bve"), 0U);
+    EXPECT_EQ(phase_calls(ref, "mem-budget-relief"), 0U);
+
+    conf.mem_budget_bytes = 1ULL << 40;
+    conf.mem_budget_share = (double)(2*1024*1024)/(double)conf.mem_budget_bytes;
+    s = new Solver(&conf, &must_inter);
+    s->new_vars(300);
+    for(const auto& cl: cls) s->add_clause_outside(cl);
+    s->simplify_with_assumptions(nullptr, &sched);
+    EXPECT_EQ(s->solve_with_assumptions(), ref_ret);
+    EXPECT_EQ(phase_calls(*s, "occ-bve"), 0U);
+    EXPECT_GT(phase_calls(*s, "mem-budget-relief"), 0U);
+    EXPECT_FALSE(s->mem_budget_hit);
+
+    //Under the budget, relief is rate limited
+    s->conf.mem_budget_share = (double)s->mem_accounted()/0.9/(double)conf.mem_budget_bytes;
+    s->check_mem_budget();
+    EXPECT_TRUE(s->mem_pressure);
+    EXPECT_FALSE(s->mem_budget_hit);
+    const uint64_t relief = phase_calls(*s, "mem-budget-relief");
+    s->check_mem_budget();
+    EXPECT_EQ(phase_calls(*s, "mem-budget-relief"), relief);
+
+    //Pressure goes away once the data is well below the share
+    s->conf.mem_budget_share *= 4;
+    s->check_mem_budget();
+    EXPECT_FALSE(s->mem_pressure);
+}
+
+
+//Every worker has its own oracle, the units one learns are shared with the
+//others. The number of threads is not capped here, whatever the number of
+//cores of the machine running the test
+TEST_F(SolverTest, oracle_parallel_vivif_shares_units)
+{
+    std::mt19937 mt(3);
+    const auto cls = random_3sat(mt, 60, 250);
+    std::atomic<bool> ref_inter(false);
+    Solver ref(&conf, &ref_inter);
+    ref.new_vars(60);
+    for(const auto& cl: cls) ref.add_clause_outside(cl);
+    const lbool ref_ret = ref.solve_with_assumptions();
+    ASSERT_NE(ref_ret, l_Undef);
+
+    s = new Solver(&conf, &must_inter);
+    s->new_vars(60);
+    for(const auto& cl: cls) s->add_clause_outside(cl);
+    auto oracle_cls = s->get_irred_cls_for_oracle();
+    s->detach_and_free_all_irred_cls();
+    bool finished = false;
+    s->oracle_vivif_parallel(oracle_cls, finished, 3);
+    EXPECT_EQ(s->oracle_par_threads, 3u);
+    EXPECT_GT(s->oracle_par_shared_units, 0u);
+
+    const lbool ret = s->solve_with_assumptions();
+    EXPECT_EQ(ret, ref_ret);
+    if (ret == l_True) {
+        EXPECT_TRUE(check_model_satisfies(cls, s->get_model()));
+    }
+}
+
+TEST_F(SolverTest, backbone_native_finds_whole_backbone)
+{
+    std::mt19937 mt(7);
+    const uint32_t n = 40;
+    const auto cls = random_3sat(mt, n, 160);
+    std::atomic<bool> ref_inter(false);
+    Solver ref(&conf, &ref_inter);
+    ref.new_vars(n);
+    for(const auto& cl: cls) ref.add_clause_outside(cl);
+    ASSERT_EQ(ref.solve_with_assumptions(), l_True);
+    const vector<lbool> model = ref.get_model();
+    vector<Lit> backbone;
+    for(uint32_t v = 0; v < n; v++) {
+        const Lit l(v, model[v] == l_False);
+        const vector<Lit> assumps{~l};
+        //Set when a solve call finishes, to stop the other threads
+        ref_inter.store(false, std::memory_order_relaxed);
+        if (ref.solve_with_assumptions(&assumps) == l_False) backbone.push_back(l);
+    }
+
+    s = new Solver(&conf, &must_inter);
+    s->new_vars(n);
+    for(const auto& cl: cls) s->add_clause_outside(cl);
+    const std::string sched = "backbone";
+    s->simplify_with_assumptions(nullptr, &sched);
+    vector<Lit> units = s->get_zero_assigned_lits();
+    std::sort(units.begin(), units.end());
+    EXPECT_FALSE(backbone.empty());
+    EXPECT_EQ(units, backbone);
+}
+
+//In BFS order, every variable is reached from its neighbour that comes
+//first, and the variables are reached in the order of those neighbours
+static bool vars_in_bfs_order(Solver& s)
+{
+    vector<uint32_t> first_nb(s.nVars(), std::numeric_limits<uint32_t>::max());
+    const auto link = [&](const uint32_t a, const uint32_t b) {
+        first_nb[a] = std::min(first_nb[a], b);
+        first_nb[b] = std::min(first_nb[b], a);
+    };
+    for(const auto off: s.longIrredCls) {
+        const Clause& cl = *s.cl_alloc.ptr(off);
+        for(const Lit a: cl) for(const Lit b: cl) if (a.var() != b.var()) link(a.var(), b.var());
+    }
+    for(uint32_t i = 0; i < s.nVars()*2; i++) {
+        const Lit l = Lit::toLit(i);
+        for(const auto& w: s.watches[l]) if (w.isBin() && !w.red()) link(l.var(), w.lit2().var());
+    }
+
+    uint32_t last = 0;
+    for(uint32_t v = 0; v < s.nVars(); v++) {
+        if (first_nb[v] > v) continue; //first of its component
+        if (first_nb[v] < last) return false;
+        last = first_nb[v];
+    }
+    return true;
+}
+
+TEST_F(SolverTest, renumber_locality_order_is_bfs)
+{
+    std::mt19937 mt(11);
+    const uint32_t n = 200;
+    //Each clause stays within a window of 10 vars, which are then shuffled
+    vector<uint32_t> perm(n);
+    for(uint32_t i = 0; i < n; i++) perm[i] = i;
+    std::shuffle(perm.begin(), perm.end(), mt);
+    vector<vector<Lit>> cls;
+    for(uint32_t i = 0; i < 300; i++) {
+        const uint32_t base = mt()%(n-10);
+        cls.push_back(random_3sat(mt, 10, 1, base)[0]);
+        for(Lit& l: cls.back()) l = Lit(perm[l.var()], l.sign());
+    }
+    const std::string sched = "scc-vrepl, must-renumber";
+
+    for(const int order: {0, 1}) {
+        conf.renumber_order = order;
+        std::atomic<bool> inter(false);
+        Solver solver(&conf, &inter);
+        solver.new_vars(n);
+        for(const auto& cl: cls) solver.add_clause_outside(cl);
+        solver.add_clause_outside({Lit(perm[0], false)});
+        solver.simplify_with_assumptions(nullptr, &sched);
+        EXPECT_EQ(vars_in_bfs_order(solver), order == 1);
+
+        ASSERT_EQ(solver.solve_with_assumptions(), l_True);
+        EXPECT_TRUE(check_model_satisfies(cls, solver.get_model()));
+    }
+}
+// Consolidation only moves clauses around in memory, so the search, and
+// thus the model and the clause database, must be the same in both modes
+TEST_F(SolverTest, consolidate_by_tier_matches_default)
+{
+    std::mt19937 mt(13);
+    const uint32_t n = 180;
+    const vector<vector<Lit>> cls = random_3sat(mt, n, 747);
+    conf.must_always_conslidate = 1;
+    conf.simplify_schedule_nonstartup = "cl-consolidate";
+    conf.num_conflicts_of_search = 200;
+    conf.num_conflicts_of_search_inc = 1.0;
+
+    struct Result {
+        lbool ret;
+        vector<lbool> model;
+        uint64_t conflicts;
+        uint32_t irred;
+        uint32_t red;
+    };
+    const auto run = [&](const int by_tier) {
+        conf.consolidate_by_tier = by_tier;
+        std::atomic<bool> inter(false);
+        Solver solver(&conf, &inter);
+        solver.new_vars(n);
+        for(const auto& cl: cls) solver.add_clause_outside(cl);
+        Result r;
+        r.ret = solver.solve_with_assumptions();
+        r.model = solver.get_model();
+        r.conflicts = solver.sumConflicts;
+        vector<Lit> lits;
+        bool is_xor;
+        bool rhs;
+        for(const bool red: {false, true}) {
+            uint32_t num = 0;
+            solver.start_getting_constraints(red);
+            while(solver.get_next_constraint(lits, is_xor, rhs)) num++;
+            solver.end_getting_constraints();
+            (red ? r.red : r.irred) = num;
+        }
+        return r;
+    };
+    const Result def = run(0);
+    const Result tier = run(1);
+
+    //Several searches, each followed by a forced consolidation
+    EXPECT_GT(def.conflicts, 5*200U);
+    ASSERT_EQ(def.ret, l_True);
+    EXPECT_EQ(tier.ret, def.ret);
+    EXPECT_EQ(tier.conflicts, def.conflicts);
+    EXPECT_EQ(tier.model, def.model);
+    EXPECT_EQ(tier.irred, def.irred);
+    EXPECT_EQ(tier.red, def.red);
+    EXPECT_TRUE(check_model_satisfies(cls, tier.model));
+}
 }
 
 int main(int argc, char **argv) {
@@ -99,6 +99,25 @@ TEST_F(sub_impl, sub_2by2_4)
     check_irred_cls_eq(s, "1, 4; 1, 2, 3, 4;-1, 2, 4");
 }
 
+//Binaries added between runs must be seen by the incremental runs
+TEST_F(sub_impl, incremental_runs_see_new_binaries)
+{
+    s->new_vars(10);
+    for(uint32_t i = 4; i < 9; i++) s->add_clause_outside({Lit(i, false), Lit(i+1, true)});
+    const std::string sched = "scc-vrepl, sub-impl, str-impl";
+    s->simplify_with_assumptions(nullptr, &sched);
+    s->simplify_with_assumptions(nullptr, &sched);
+
+    s->add_clause_outside(str_to_cl("1, -2"));
+    s->add_clause_outside(str_to_cl("-1, 2"));
+    s->add_clause_outside(str_to_cl("3, 4"));
+    s->add_clause_outside(str_to_cl("3, -4"));
+    s->simplify_with_assumptions(nullptr, &sched);
+
+    EXPECT_EQ(s->get_all_binary_xors().size(), 1u);
+    check_zero_assigned_lits_contains(s, "3");
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -40,6 +40,7 @@ THE SOFTWARE.
 #include <cctype>
 #include <cassert>
 #include <algorithm>
+#include <random>
 #include "src/solver.h"
 #include "src/xor.h"
 #include "cryptominisat5/cryptominisat.h"
@@ -657,6 +658,35 @@ inline void get_all_irred_clauses(SATSolver&s, std::vector<Lit>& lits) {
     }
 }
 
+//Random 3-SAT clauses over the variables [first_var, first_var+num_vars)
+inline vector<vector<Lit> > random_3sat(
+    std::mt19937& mt, uint32_t num_vars, uint32_t num_cls, uint32_t first_var = 0)
+{
+    vector<vector<Lit> > cls;
+    for(uint32_t i = 0; i < num_cls; i++) {
+        vector<Lit> cl;
+        for(uint32_t j = 0; j < 3; j++) {
+            cl.push_back(Lit(first_var + mt()%num_vars, mt()%2));
+        }
+        cls.push_back(cl);
+    }
+    return cls;
+}
+
+//Whether every clause has a literal that is TRUE in "model"
+inline bool check_model_satisfies(
+    const vector<vector<Lit> >& cls, const vector<lbool>& model)
+{
+    for(const auto& cl: cls) {
+        bool sat = false;
+        for(const Lit l: cl) {
+            if (l.var() < model.size() && (model[l.var()] ^ l.sign()) == l_True) sat = true;
+        }
+        if (!sat) return false;
+    }
+    return true;
+}
+
 // string print(const vector<Lit>& dat) {
 //     std::stringstream m;
 //     for(size_t i = 0; i < dat.size();) {